@@ -0,0 +1,40 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 基准测试需要优化后的代码才有意义
+CONFIG += release
+CONFIG -= debug
+
+INCLUDEPATH += ../Gocommon ../Goserver ../Goclient
+
+SOURCES += \
+    ../Gocommon/goboard.cpp \
+    ../Gocommon/patterntable.cpp \
+    ../Gocommon/playoutboard.cpp \
+    ../Goclient/influencemap.cpp \
+    ../Goserver/gameroom.cpp \
+    ../Goserver/lobbyindex.cpp \
+    ../Goserver/ratelimiter.cpp \
+    boardbench.cpp \
+    influencebench.cpp \
+    main.cpp \
+    playoutbench.cpp \
+    referenceboard.cpp \
+    roombench.cpp
+
+HEADERS += \
+    ../Gocommon/goboard.h \
+    ../Gocommon/patterntable.h \
+    ../Gocommon/playoutboard.h \
+    ../Goclient/influencemap.h \
+    ../Goserver/gameroom.h \
+    ../Goserver/lobbyindex.h \
+    ../Goserver/ratelimiter.h \
+    boardbench.h \
+    influencebench.h \
+    playoutbench.h \
+    referenceboard.h \
+    roombench.h
@@ -0,0 +1,440 @@
+#include "boardbench.h"
+#include "goboard.h"
+#include "referenceboard.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef GoBoard::Stone Stone;
+typedef std::pair<int, int> Point;
+
+const int N = GoBoard::BOARD_SIZE;
+const int DX[4] = { -1, 1, 0, 0 };
+const int DY[4] = { 0, 0, -1, 1 };
+
+// 防止计时循环被编译器优化掉
+volatile long long g_sink = 0;
+
+// 随机对局的最大手数（防止极端情况下不终局）
+const int MAX_PLIES = N * N * 3;
+
+// 默认盘数下差分对局的合法着法总数（规则改动导致数值变化时需确认后更新）
+const long long EXPECTED_LEGAL_MOVES = 801935;
+
+// 用字符串描述局面：'X' 黑，'O' 白，'.' 空；第 y 行第 x 列
+template<class Board>
+void loadPosition(Board& board, const std::vector<std::string>& rows)
+{
+    board.clear();
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            char c = rows[y][x];
+            board.set(x, y, c == 'X' ? GoBoard::BLACK : c == 'O' ? GoBoard::WHITE : GoBoard::EMPTY);
+        }
+    }
+}
+
+template<class Board>
+std::vector<std::string> savePosition(const Board& board)
+{
+    std::vector<std::string> rows(N, std::string(N, '.'));
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            Stone s = board.at(x, y);
+            rows[y][x] = s == GoBoard::BLACK ? 'X' : s == GoBoard::WHITE ? 'O' : '.';
+        }
+    }
+    return rows;
+}
+
+template<class A, class B>
+bool sameBoard(const A& a, const B& b)
+{
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y)
+            if (a.at(x, y) != b.at(x, y))
+                return false;
+    return true;
+}
+
+// 一块棋的全部气（仅用于生成征子局面）
+template<class Board>
+std::vector<Point> libertiesOf(const Board& board, int x, int y)
+{
+    Stone color = board.at(x, y);
+    std::vector<char> seen(N * N, 0);
+    std::vector<Point> stack{{x, y}};
+    std::vector<Point> liberties;
+    seen[x * N + y] = 1;
+    while (!stack.empty()) {
+        auto [cx, cy] = stack.back();
+        stack.pop_back();
+        for (int d = 0; d < 4; ++d) {
+            int nx = cx + DX[d];
+            int ny = cy + DY[d];
+            if (!GoBoard::isValidPosition(nx, ny) || seen[nx * N + ny])
+                continue;
+            if (board.at(nx, ny) == GoBoard::EMPTY) {
+                seen[nx * N + ny] = 1;
+                liberties.push_back({nx, ny});
+            } else if (board.at(nx, ny) == color) {
+                seen[nx * N + ny] = 1;
+                stack.push_back({nx, ny});
+            }
+        }
+    }
+    return liberties;
+}
+
+// 己方眼位：四周都是己方棋子或棋盘边缘，随机对局不填
+template<class Board>
+bool isOwnEye(const Board& board, int x, int y, Stone color)
+{
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + DX[d];
+        int ny = y + DY[d];
+        if (GoBoard::isValidPosition(nx, ny) && board.at(nx, ny) != color)
+            return false;
+    }
+    return true;
+}
+
+// 大龙：除右下角一点外全是黑子，只有一口气
+std::vector<std::string> largeGroupPosition()
+{
+    std::vector<std::string> rows(N, std::string(N, 'X'));
+    rows[N - 1][N - 1] = '.';
+    return rows;
+}
+
+// 同一条大龙，最后一口气已被白子占住：没有气，搜索必须走遍全部棋子
+std::vector<std::string> deadGroupPosition()
+{
+    std::vector<std::string> rows = largeGroupPosition();
+    rows[N - 1][N - 1] = 'O';
+    return rows;
+}
+
+// 无气大龙上 hasLiberty 应返回 false 且找到全部 N*N-1 颗黑子
+template<class Board>
+bool searchesWholeGroup(const std::vector<std::string>& deadGroup)
+{
+    Board board;
+    loadPosition(board, deadGroup);
+    std::vector<Point> visited;
+    bool alive = board.hasLiberty(0, 0, GoBoard::BLACK, visited);
+    return !alive && visited.size() == size_t(N * N - 1);
+}
+
+// 征子：白子从 (3,3) 开始被一路征到棋盘边缘
+struct LadderScenario {
+    std::vector<std::string> setup;
+    std::vector<Point> moves;   // 黑白交替，黑先
+};
+
+LadderScenario ladderScenario()
+{
+    GoBoard board;
+    board.set(3, 3, GoBoard::WHITE);
+    board.set(3, 2, GoBoard::BLACK);
+    board.set(2, 3, GoBoard::BLACK);
+    board.set(4, 2, GoBoard::BLACK);
+
+    LadderScenario scenario;
+    scenario.setup = savePosition(board);
+
+    Point head(3, 3);
+    while (true) {
+        std::vector<Point> libs = libertiesOf(board, head.first, head.second);
+        if (libs.size() == 1) {
+            // 只剩一口气：提掉整条征子
+            scenario.moves.push_back(libs[0]);
+            board.play(libs[0].first, libs[0].second, GoBoard::BLACK);
+            break;
+        }
+        // 选择使白棋逃出后仍只有两口气（或更少）的叫吃点
+        bool found = false;
+        for (const Point& atari : libs) {
+            GoBoard trial = board;
+            trial.play(atari.first, atari.second, GoBoard::BLACK);
+            std::vector<Point> escape = libertiesOf(trial, head.first, head.second);
+            if (escape.size() != 1)
+                continue;
+            if (!trial.play(escape[0].first, escape[0].second, GoBoard::WHITE))
+                continue;
+            if (libertiesOf(trial, head.first, head.second).size() <= 2) {
+                scenario.moves.push_back(atari);
+                scenario.moves.push_back(escape[0]);
+                board = trial;
+                head = escape[0];
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            break;
+    }
+    return scenario;
+}
+
+// 劫：黑方刚在 (10,9) 提掉 (9,9) 的白子
+template<class Board>
+void setupKo(Board& board)
+{
+    board.clear();
+    board.set(9, 9, GoBoard::WHITE);
+    board.set(8, 9, GoBoard::BLACK);
+    board.set(9, 8, GoBoard::BLACK);
+    board.set(9, 10, GoBoard::BLACK);
+    board.set(10, 8, GoBoard::WHITE);
+    board.set(10, 10, GoBoard::WHITE);
+    board.set(11, 9, GoBoard::WHITE);
+    board.play(10, 9, GoBoard::BLACK);
+}
+
+// 随机对局一步：在空点中均匀随机挑选，非法或填己方眼位则换一点；无点可下时虚着
+template<class Board>
+bool randomMove(Board& board, Stone color, std::mt19937& rng, std::vector<Point>& candidates, Point& move)
+{
+    candidates.clear();
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y)
+            if (board.at(x, y) == GoBoard::EMPTY)
+                candidates.push_back({x, y});
+
+    while (!candidates.empty()) {
+        size_t i = rng() % candidates.size();
+        Point p = candidates[i];
+        candidates[i] = candidates.back();
+        candidates.pop_back();
+        if (!isOwnEye(board, p.first, p.second, color) && board.play(p.first, p.second, color)) {
+            move = p;
+            return true;
+        }
+    }
+    board.pass(color);
+    return false;
+}
+
+// 完整随机对局，返回手数
+template<class Board>
+int randomPlayout(Board& board, std::mt19937& rng)
+{
+    std::vector<Point> candidates;
+    candidates.reserve(N * N);
+    Stone color = GoBoard::BLACK;
+    int passes = 0;
+    int plies = 0;
+    while (passes < 2 && plies < MAX_PLIES) {
+        Point move;
+        passes = randomMove(board, color, rng, candidates, move) ? 0 : passes + 1;
+        color = GoBoard::opponent(color);
+        ++plies;
+    }
+    return plies;
+}
+
+// 终局：固定种子的随机对局下到双方虚着
+std::vector<std::string> endgamePosition()
+{
+    GoBoard board;
+    std::mt19937 rng(7);
+    randomPlayout(board, rng);
+    return savePosition(board);
+}
+
+// 差分对局：两种实现同步下同一盘随机棋，每一步比较全部合法着法与棋盘
+bool differentialPlayout(unsigned seed, long long& legalMoves, long long& plies)
+{
+    ReferenceBoard reference;
+    GoBoard board;
+    std::mt19937 rng(seed);
+    Stone color = GoBoard::BLACK;
+    int passes = 0;
+    std::vector<Point> choices;
+
+    for (int ply = 0; passes < 2 && ply < MAX_PLIES; ++ply) {
+        choices.clear();
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                bool expected = reference.isLegalMove(x, y, color);
+                if (board.isLegalMove(x, y, color) != expected) {
+                    std::printf("MISMATCH seed %u ply %d: isLegalMove(%d, %d) reference=%d\n",
+                                seed, ply, x, y, expected);
+                    return false;
+                }
+                if (expected) {
+                    ++legalMoves;
+                    if (!isOwnEye(reference, x, y, color))
+                        choices.push_back({x, y});
+                }
+            }
+        }
+
+        if (choices.empty()) {
+            reference.pass(color);
+            board.pass(color);
+            ++passes;
+        } else {
+            Point p = choices[rng() % choices.size()];
+            bool a = reference.play(p.first, p.second, color);
+            bool b = board.play(p.first, p.second, color);
+            if (!a || !b || !sameBoard(reference, board)) {
+                std::printf("MISMATCH seed %u ply %d: play(%d, %d) reference=%d board=%d\n",
+                            seed, ply, p.first, p.second, a, b);
+                return false;
+            }
+            passes = 0;
+        }
+        color = GoBoard::opponent(color);
+        ++plies;
+    }
+    return true;
+}
+
+template<class Board>
+void benchmarkImpl(const char* impl,
+                   const std::vector<std::string>& largeGroup,
+                   const std::vector<std::string>& deadGroup,
+                   const LadderScenario& ladder,
+                   const std::vector<std::string>& endgame)
+{
+    std::vector<Point> visited;
+    visited.reserve(N * N);
+
+    // hasLiberty：大龙没有气，两种实现都要搜遍全部棋子
+    Board board;
+    loadPosition(board, deadGroup);
+    printResult("hasLiberty/dead-group", impl, measureNs([&] {
+        visited.clear();
+        g_sink += board.hasLiberty(0, 0, GoBoard::BLACK, visited);
+    }));
+
+    // checkAndRemoveDeadStones + removeStones：白方提掉整条大龙（含复制棋盘）
+    Board base;
+    loadPosition(base, largeGroup);
+    printResult("play/capture-large-group", impl, measureNs([&] {
+        board = base;
+        g_sink += board.play(N - 1, N - 1, GoBoard::WHITE);
+    }));
+
+    // removeStones：移除整条大龙后原样放回
+    loadPosition(board, deadGroup);
+    visited.clear();
+    board.hasLiberty(0, 0, GoBoard::BLACK, visited);
+    printResult("removeStones/dead-group", impl, measureNs([&] {
+        board.removeStones(visited);
+        for (const Point& p : visited)
+            board.set(p.first, p.second, GoBoard::BLACK);
+    }));
+
+    // 征子：从初始局面逐手下完整条征子
+    Board ladderBase;
+    loadPosition(ladderBase, ladder.setup);
+    printResult("play/ladder-sequence", impl, measureNs([&] {
+        board = ladderBase;
+        Stone color = GoBoard::BLACK;
+        for (const Point& p : ladder.moves) {
+            g_sink += board.play(p.first, p.second, color);
+            color = GoBoard::opponent(color);
+        }
+    }));
+
+    // 终局：每颗棋子都检查一次气
+    loadPosition(board, endgame);
+    printResult("hasLiberty/endgame-all-stones", impl, measureNs([&] {
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                Stone s = board.at(x, y);
+                if (s != GoBoard::EMPTY) {
+                    visited.clear();
+                    g_sink += board.hasLiberty(x, y, s, visited);
+                }
+            }
+        }
+    }));
+
+    // 终局：双方全部合法着法
+    printResult("isLegalMove/endgame-all-points", impl, measureNs([&] {
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                g_sink += board.isLegalMove(x, y, GoBoard::BLACK);
+                g_sink += board.isLegalMove(x, y, GoBoard::WHITE);
+            }
+        }
+    }));
+
+    // 劫争判断：全盘每点查询一次
+    setupKo(board);
+    printResult("isKo/all-points", impl, measureNs([&] {
+        for (int x = 0; x < N; ++x)
+            for (int y = 0; y < N; ++y)
+                g_sink += board.isKo(x, y, GoBoard::WHITE);
+    }));
+
+    // 随机对局速度
+    std::mt19937 rng(1);
+    long long plies = 0;
+    double ns = measureNs([&] {
+        board.clear();
+        plies += randomPlayout(board, rng);
+    });
+    std::printf("%-40s %-10s %14.1f playouts/s\n", "random-playout", impl, 1e9 / ns);
+}
+
+} // namespace
+
+int runBoardBenchmarks(int playouts)
+{
+    int failures = 0;
+
+    std::vector<std::string> largeGroup = largeGroupPosition();
+    std::vector<std::string> deadGroup = deadGroupPosition();
+    LadderScenario ladder = ladderScenario();
+    std::vector<std::string> endgame = endgamePosition();
+
+    // 局面自检：征子应以提子结束，劫争局面应禁止白方立即提回
+    {
+        GoBoard board;
+        loadPosition(board, ladder.setup);
+        Stone color = GoBoard::BLACK;
+        for (const Point& p : ladder.moves) {
+            board.play(p.first, p.second, color);
+            color = GoBoard::opponent(color);
+        }
+        if (ladder.moves.size() < 20 || board.at(3, 3) != GoBoard::EMPTY) {
+            std::printf("FAIL ladder scenario (%zu moves)\n", ladder.moves.size());
+            ++failures;
+        }
+        setupKo(board);
+        if (!board.isKo(9, 9, GoBoard::WHITE) || board.isLegalMove(9, 9, GoBoard::WHITE)) {
+            std::printf("FAIL ko scenario\n");
+            ++failures;
+        }
+        if (!searchesWholeGroup<ReferenceBoard>(deadGroup) || !searchesWholeGroup<GoBoard>(deadGroup)) {
+            std::printf("FAIL dead group search does not cover the whole group\n");
+            ++failures;
+        }
+    }
+
+    // perft 式计数：差分对局累计合法着法数
+    long long legalMoves = 0;
+    long long plies = 0;
+    for (int i = 0; i < playouts; ++i) {
+        if (!differentialPlayout(static_cast<unsigned>(i + 1), legalMoves, plies))
+            ++failures;
+    }
+    std::printf("perft: %d playouts, %lld plies, %lld legal moves\n", playouts, plies, legalMoves);
+    if (playouts == BENCH_DEFAULT_PLAYOUTS && legalMoves != EXPECTED_LEGAL_MOVES) {
+        std::printf("FAIL perft legal move count, expected %lld\n", EXPECTED_LEGAL_MOVES);
+        ++failures;
+    }
+
+    benchmarkImpl<ReferenceBoard>("reference", largeGroup, deadGroup, ladder, endgame);
+    benchmarkImpl<GoBoard>("goboard", largeGroup, deadGroup, ladder, endgame);
+
+    return failures;
+}
@@ -0,0 +1,41 @@
+#ifndef BOARDBENCH_H
+#define BOARDBENCH_H
+
+#include <chrono>
+#include <cstdio>
+
+// 每项计时至少运行的时长（毫秒）
+const int BENCH_MIN_MS = 200;
+// 默认的差分对局盘数
+const int BENCH_DEFAULT_PLAYOUTS = 10;
+
+// 反复运行 fn 直到累计时长达标，返回平均每次调用的纳秒数
+template<class F>
+double measureNs(F&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+    long long iterations = 0;
+    long long batch = 1;
+    Clock::time_point start = Clock::now();
+    Clock::duration elapsed{};
+    while (elapsed < std::chrono::milliseconds(BENCH_MIN_MS)) {
+        for (long long i = 0; i < batch; ++i) {
+            fn();
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsed = Clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+// 输出一行结果
+inline void printResult(const char* name, const char* impl, double nsPerOp)
+{
+    std::printf("%-40s %-10s %14.1f ns/op\n", name, impl, nsPerOp);
+}
+
+// 棋盘规则基准与差分校验（参考实现 vs GoBoard），返回失败项数
+int runBoardBenchmarks(int playouts);
+
+#endif // BOARDBENCH_H
@@ -0,0 +1,76 @@
+#include "influencebench.h"
+#include "boardbench.h"
+#include "influencemap.h"
+
+#include <cmath>
+#include <random>
+
+namespace {
+typedef InfluenceMap::StoneChange StoneChange;
+const int N = InfluenceMap::BOARD_SIZE;
+volatile long long g_influenceSink = 0;
+}
+
+int runInfluenceBenchmarks()
+{
+    int failures = 0;
+
+    // 随机对局中途的局面：逐手记录变化
+    GoBoard board;
+    std::mt19937 rng(3);
+    std::vector<std::vector<StoneChange>> moves;
+    GoBoard::Stone color = GoBoard::BLACK;
+    for (int attempts = 0; moves.size() < 200 && attempts < 10000; ++attempts) {
+        int x = rng() % N;
+        int y = rng() % N;
+        if (!board.play(x, y, color))
+            continue;
+        std::vector<StoneChange> changes;
+        changes.push_back({x, y, GoBoard::EMPTY, color});
+        for (const auto& [cx, cy] : board.lastCapture(color).positions)
+            changes.push_back({cx, cy, GoBoard::opponent(color), GoBoard::EMPTY});
+        moves.push_back(changes);
+        color = GoBoard::opponent(color);
+    }
+
+    // 增量结果应与一次性从头计算一致
+    InfluenceMap incremental;
+    for (const auto& changes : moves)
+        incremental.apply(changes);
+    std::vector<StoneChange> all;
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y)
+            if (board.at(x, y) != GoBoard::EMPTY)
+                all.push_back({x, y, GoBoard::EMPTY, board.at(x, y)});
+    InfluenceMap full;
+    full.apply(all);
+    for (int i = 0; i < N * N; ++i) {
+        if (std::fabs(full.ownership()[i] - incremental.ownership()[i]) > 1e-4f) {
+            std::printf("FAIL influence incremental != full at %d\n", i);
+            ++failures;
+            break;
+        }
+    }
+    if (full.blackPoints() != incremental.blackPoints() || full.whitePoints() != incremental.whitePoints()) {
+        std::printf("FAIL influence territory counts differ\n");
+        ++failures;
+    }
+
+    InfluenceMap map;
+    size_t next = 0;
+    printResult("InfluenceMap::apply/one-move", "influence", measureNs([&] {
+        if (next == moves.size()) {
+            map.clear();
+            next = 0;
+        }
+        map.apply(moves[next++]);
+        g_influenceSink += map.blackPoints();
+    }));
+    printResult("InfluenceMap::apply/full-board", "influence", measureNs([&] {
+        map.clear();
+        map.apply(all);
+        g_influenceSink += map.blackPoints();
+    }));
+
+    return failures;
+}
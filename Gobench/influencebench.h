@@ -0,0 +1,7 @@
+#ifndef INFLUENCEBENCH_H
+#define INFLUENCEBENCH_H
+
+// 形势判断的增量更新开销（须远小于一帧）
+int runInfluenceBenchmarks();
+
+#endif // INFLUENCEBENCH_H
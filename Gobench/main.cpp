@@ -0,0 +1,30 @@
+#include "boardbench.h"
+#include "influencebench.h"
+#include "playoutbench.h"
+#include "roombench.h"
+#include <QCoreApplication>
+#include <QStringList>
+
+// 用法：GoBench [差分对局盘数]
+// 存在差分不一致或规则自检失败时返回非零
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    int playouts = BENCH_DEFAULT_PLAYOUTS;
+    QStringList args = a.arguments();
+    if (args.size() > 1) {
+        playouts = args[1].toInt();
+    }
+
+    int failures = runBoardBenchmarks(playouts);
+    failures += runRoomBenchmarks();
+    failures += runInfluenceBenchmarks();
+    failures += runPlayoutBenchmarks(playouts);
+
+    if (failures > 0) {
+        std::printf("%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+#include "playoutbench.h"
+#include "boardbench.h"
+#include "playoutboard.h"
+#include "referenceboard.h"
+
+#include <QDir>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+typedef GoBoard::Stone Stone;
+const int N = GoBoard::BOARD_SIZE;
+const int MAX_PLIES = N * N * 3;
+volatile long long g_playoutSink = 0;
+
+// 从棋盘颜色从头计算一点的 3×3 编码，用于校验增量维护
+int patternFromScratch(const PlayoutBoard& board, int x, int y)
+{
+    static const int DX[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+    static const int DY[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    int code = 0;
+    for (int k = 0; k < 8; ++k) {
+        int nx = x + DX[k], ny = y + DY[k];
+        int field = GoBoard::isValidPosition(nx, ny) ? int(board.at(nx, ny)) : int(PatternTable::FIELD_OFF);
+        code |= field << (2 * k);
+    }
+    return code;
+}
+
+// 参考实现与快速棋盘同步下随机对局，逐手比较合法着法、棋盘与模式编码
+int differentialGame(const PatternTable& table, unsigned seed)
+{
+    ReferenceBoard reference;
+    PlayoutBoard fast(table);
+    std::mt19937 rng(seed);
+    Stone color = GoBoard::BLACK;
+    int passes = 0;
+
+    for (int ply = 0; ply < MAX_PLIES && passes < 2; ++ply) {
+        std::vector<std::pair<int, int>> legal;
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                bool expected = reference.isLegalMove(x, y, color);
+                if (fast.isLegal(x, y, color) != expected) {
+                    std::printf("MISMATCH playout seed %u ply %d: isLegal(%d, %d) reference=%d\n",
+                                seed, ply, x, y, expected);
+                    return 1;
+                }
+                if (fast.pattern(x, y) != patternFromScratch(fast, x, y)) {
+                    std::printf("MISMATCH playout seed %u ply %d: pattern(%d, %d)\n", seed, ply, x, y);
+                    return 1;
+                }
+                // 不填己方眼，保证对局能终局
+                if (expected && table.weights(color)[fast.pattern(x, y)] != 0)
+                    legal.push_back({x, y});
+            }
+        }
+
+        if (legal.empty()) {
+            reference.pass(color);
+            fast.pass();
+            ++passes;
+        } else {
+            auto [x, y] = legal[rng() % legal.size()];
+            reference.play(x, y, color);
+            fast.play(x, y, color);
+            passes = 0;
+        }
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                if (fast.at(x, y) != reference.at(x, y)) {
+                    std::printf("MISMATCH playout seed %u ply %d: board at (%d, %d)\n", seed, ply, x, y);
+                    return 1;
+                }
+            }
+        }
+        color = GoBoard::opponent(color);
+    }
+    return 0;
+}
+
+// 权重自洽：棋子与盘外为0，空点等于查表结果（随机选点时暂时排除的点已恢复），
+// 每行之和与总和等于各点权重相加
+bool weightsConsistent(const PlayoutBoard& board, const PatternTable& table, Stone color,
+                       unsigned seed, int ply)
+{
+    int total = 0;
+    for (int x = -1; x <= N; ++x) {
+        int row = 0;
+        for (int y = -1; y <= N; ++y) {
+            int expected = (GoBoard::isValidPosition(x, y) && board.at(x, y) == GoBoard::EMPTY)
+                ? table.weights(color)[board.pattern(x, y)] : 0;
+            if (board.weight(color, x, y) != expected) {
+                std::printf("MISMATCH checked playout seed %u ply %d: weight(%d, %d, %d) = %d, expected %d\n",
+                            seed, ply, int(color), x, y, board.weight(color, x, y), expected);
+                return false;
+            }
+            row += expected;
+        }
+        if (board.rowWeight(color, x) != row) {
+            std::printf("MISMATCH checked playout seed %u ply %d: rowWeight(%d, %d)\n", seed, ply, int(color), x);
+            return false;
+        }
+        total += row;
+    }
+    if (board.totalWeight(color) != total) {
+        std::printf("MISMATCH checked playout seed %u ply %d: totalWeight(%d)\n", seed, ply, int(color));
+        return false;
+    }
+    return true;
+}
+
+// 实际落子并数提子：四周只有对方棋子或盘外，且恰好提掉一子
+bool koCaptureByPlay(const ReferenceBoard& reference, int x, int y, Stone color)
+{
+    static const int DX[4] = { -1, 1, 0, 0 };
+    static const int DY[4] = { 0, 0, -1, 1 };
+    Stone opponent = GoBoard::opponent(color);
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + DX[d], ny = y + DY[d];
+        if (GoBoard::isValidPosition(nx, ny) && reference.at(nx, ny) != opponent)
+            return false;
+    }
+    auto count = [opponent](const ReferenceBoard& board) {
+        int stones = 0;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j)
+                stones += (board.at(i, j) == opponent);
+        }
+        return stones;
+    };
+    ReferenceBoard after = reference;
+    return after.play(x, y, color) && count(reference) - count(after) == 1;
+}
+
+// 用 playRandom 下随机对局，每手检查权重、抽样结果与提劫判断；
+// excludable 累计出现"有权重但不合法的点"（会被抽样暂时排除）的手数
+int checkedRandomGame(const PatternTable& table, unsigned seed, int* excludable)
+{
+    ReferenceBoard reference;
+    PlayoutBoard fast(table);
+    PlayoutBoard::Random random(seed);
+    Stone color = GoBoard::BLACK;
+    int passes = 0;
+
+    for (int ply = 0; ply < MAX_PLIES && passes < 2; ++ply) {
+        if (!weightsConsistent(fast, table, GoBoard::BLACK, seed, ply)
+            || !weightsConsistent(fast, table, GoBoard::WHITE, seed, ply))
+            return 1;
+
+        int before[N][N];
+        bool canPlay = false;
+        bool hasExcludable = false;
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                before[x][y] = fast.weight(color, x, y);
+                bool legal = fast.isLegal(x, y, color);
+                canPlay |= (legal && before[x][y] > 0);
+                hasExcludable |= (!legal && before[x][y] > 0);
+                if (legal && fast.isKoCapture(x, y, color) != koCaptureByPlay(reference, x, y, color)) {
+                    std::printf("MISMATCH checked playout seed %u ply %d: isKoCapture(%d, %d)\n", seed, ply, x, y);
+                    return 1;
+                }
+            }
+        }
+        *excludable += hasExcludable;
+
+        // 只要还有带权重的合法点就必须落子，且落在其中之一
+        int x = -1, y = -1;
+        bool played = fast.playRandom(color, random, &x, &y);
+        if (played != canPlay || (played && (before[x][y] == 0 || !reference.play(x, y, color)))) {
+            std::printf("MISMATCH checked playout seed %u ply %d: playRandom played=%d at (%d, %d)\n",
+                        seed, ply, played, x, y);
+            return 1;
+        }
+        if (!played)
+            reference.pass(color);
+        passes = played ? 0 : passes + 1;
+
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                if (fast.at(i, j) != reference.at(i, j)) {
+                    std::printf("MISMATCH checked playout seed %u ply %d: board at (%d, %d)\n", seed, ply, i, j);
+                    return 1;
+                }
+            }
+        }
+        color = GoBoard::opponent(color);
+    }
+    return 0;
+}
+}
+
+int runPlayoutBenchmarks(int games)
+{
+    int failures = 0;
+
+    // 经文件映射加载模式表，同时验证文件内容与内置表一致
+    PatternTable table;
+    QString path = QDir::temp().filePath("gobench-patterns.bin");
+    QFile::remove(path);
+    if (!table.open(path) || !table.isMapped()) {
+        std::printf("FAIL pattern table could not be mapped from %s\n", qPrintable(path));
+        ++failures;
+    }
+    PatternTable builtin;
+    for (int color = GoBoard::BLACK; color <= GoBoard::WHITE; ++color) {
+        if (!std::equal(builtin.weights(color), builtin.weights(color) + PatternTable::PATTERN_COUNT,
+                        table.weights(color))) {
+            std::printf("FAIL mapped pattern table differs from built-in table\n");
+            ++failures;
+            break;
+        }
+    }
+
+    for (int i = 0; i < games; ++i) {
+        failures += differentialGame(table, 2000 + i);
+    }
+    int excludable = 0;
+    for (int i = 0; i < games; ++i) {
+        failures += checkedRandomGame(table, 3000 + i, &excludable);
+    }
+    // 抽样排除与恢复必须真的被走到过，否则上面的权重检查说明不了什么
+    if (games > 0 && excludable == 0) {
+        std::printf("FAIL checked playouts never met an illegal weighted point\n");
+        ++failures;
+    }
+
+    // 从 GoBoard 载入的局面应与逐手下出的一致
+    GoBoard board;
+    PlayoutBoard loaded(table);
+    PlayoutBoard played(table);
+    PlayoutBoard::Random random(7);
+    Stone color = GoBoard::BLACK;
+    for (int i = 0; i < 150; ++i) {
+        int x, y;
+        if (played.playRandom(color, random, &x, &y))
+            board.play(x, y, color);
+        else
+            board.pass(color);
+        color = GoBoard::opponent(color);
+    }
+    loaded.load(board, color);
+    for (int x = 0; x < N && failures == 0; ++x) {
+        for (int y = 0; y < N; ++y) {
+            if (loaded.at(x, y) != played.at(x, y) || loaded.isLegal(x, y, color) != played.isLegal(x, y, color)
+                || loaded.pattern(x, y) != played.pattern(x, y)) {
+                std::printf("FAIL PlayoutBoard::load differs at (%d, %d)\n", x, y);
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    const PlayoutBoard empty(table);
+    PlayoutBoard playout(table);
+    std::vector<int> lengths;
+    double ns = measureNs([&] {
+        playout = empty;
+        lengths.push_back(playout.playout(GoBoard::BLACK, random, MAX_PLIES));
+        g_playoutSink += playout.areaScore();
+    });
+    printResult("PlayoutBoard::playout", "pattern", ns);
+    std::printf("%-40s %-10s %14.1f playouts/s\n", "pattern-playout", "pattern", 1e9 / ns);
+
+    // 自然终局的手数分布；达到上限说明仍有未被打破的循环
+    std::sort(lengths.begin(), lengths.end());
+    size_t timed = lengths.size();
+    long long plies = 0;
+    for (int length : lengths)
+        plies += length;
+    std::printf("playout length: %zu games, mean %.1f, min %d, median %d, p99 %d, max %d, %ld hit the %d-ply cap\n",
+                timed, double(plies) / timed, lengths.front(), lengths[timed / 2], lengths[timed * 99 / 100],
+                lengths.back(), long(std::count(lengths.begin(), lengths.end(), MAX_PLIES)), MAX_PLIES);
+
+    return failures;
+}
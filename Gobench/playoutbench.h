@@ -0,0 +1,7 @@
+#ifndef PLAYOUTBENCH_H
+#define PLAYOUTBENCH_H
+
+// 快速随机对局棋盘：与参考实现的差分校验及每秒对局数，返回失败项数
+int runPlayoutBenchmarks(int games);
+
+#endif // PLAYOUTBENCH_H
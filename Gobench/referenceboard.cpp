@@ -0,0 +1,141 @@
+#include "referenceboard.h"
+
+#include <queue>
+
+ReferenceBoard::ReferenceBoard()
+{
+    clear();
+}
+
+void ReferenceBoard::clear()
+{
+    board.assign(BOARD_SIZE, std::vector<Stone>(BOARD_SIZE, EMPTY));
+    lastMove = {-1, -1};
+    lastBlackCapture = CaptureInfo();
+    lastWhiteCapture = CaptureInfo();
+}
+
+bool ReferenceBoard::play(int x, int y, Stone color)
+{
+    if (color == EMPTY || !GoBoard::isValidPosition(x, y) || board[x][y] != EMPTY)
+        return false;
+    if (isKo(x, y, color))
+        return false;
+
+    board[x][y] = color;
+    return checkAndRemoveDeadStones(x, y);
+}
+
+void ReferenceBoard::pass(Stone color)
+{
+    if (color == BLACK) {
+        lastBlackCapture = CaptureInfo();
+    } else {
+        lastWhiteCapture = CaptureInfo();
+    }
+}
+
+// 最直接的做法：在副本上落子看是否成功
+bool ReferenceBoard::isLegalMove(int x, int y, Stone color)
+{
+    ReferenceBoard copy = *this;
+    return copy.play(x, y, color);
+}
+
+bool ReferenceBoard::checkAndRemoveDeadStones(int x, int y)
+{
+    Stone currentColor = board[x][y];
+    Stone opponentColor = (currentColor == BLACK) ? WHITE : BLACK;
+
+    CaptureInfo currentCapture;
+
+    const std::pair<int, int> directions[4] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+    for (const auto& dir : directions) {
+        int nx = x + dir.first;
+        int ny = y + dir.second;
+
+        if (GoBoard::isValidPosition(nx, ny) && board[nx][ny] == opponentColor) {
+            std::vector<std::pair<int, int>> visited;
+            if (!hasLiberty(nx, ny, opponentColor, visited)) {
+                for (const auto& pos : visited) {
+                    currentCapture.positions.push_back(pos);
+                }
+                removeStones(visited);
+            }
+        }
+    }
+
+    std::vector<std::pair<int, int>> visitedSelf;
+    if (!hasLiberty(x, y, currentColor, visitedSelf)) {
+        board[x][y] = EMPTY;
+        return false;
+    }
+
+    currentCapture.count = static_cast<int>(currentCapture.positions.size());
+    if (currentColor == BLACK) {
+        lastBlackCapture = currentCapture;
+    } else {
+        lastWhiteCapture = currentCapture;
+    }
+
+    lastMove = {x, y};
+    return true;
+}
+
+bool ReferenceBoard::hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited)
+{
+    if (!GoBoard::isValidPosition(x, y) || board[x][y] != color)
+        return false;
+
+    std::queue<std::pair<int, int>> q;
+    std::vector<std::vector<bool>> visitedGrid(BOARD_SIZE, std::vector<bool>(BOARD_SIZE, false));
+
+    q.push({x, y});
+    visitedGrid[x][y] = true;
+
+    while (!q.empty()) {
+        auto [cx, cy] = q.front();
+        q.pop();
+        visited.push_back({cx, cy});
+
+        std::vector<std::pair<int, int>> directions = {
+            {-1, 0}, {1, 0}, {0, -1}, {0, 1}
+        };
+
+        for (const auto& dir : directions) {
+            int nx = cx + dir.first;
+            int ny = cy + dir.second;
+
+            if (!GoBoard::isValidPosition(nx, ny))
+                continue;
+
+            if (board[nx][ny] == EMPTY) {
+                return true;
+            } else if (board[nx][ny] == color && !visitedGrid[nx][ny]) {
+                q.push({nx, ny});
+                visitedGrid[nx][ny] = true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void ReferenceBoard::removeStones(const std::vector<std::pair<int, int>>& stones)
+{
+    for (const auto& [x, y] : stones) {
+        board[x][y] = EMPTY;
+    }
+}
+
+bool ReferenceBoard::isKo(int x, int y, Stone color) const
+{
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    const CaptureInfo& opponentLastCapture =
+        (opponentColor == BLACK) ? lastBlackCapture : lastWhiteCapture;
+
+    return (opponentLastCapture.count == 1
+            && !opponentLastCapture.positions.empty()
+            && opponentLastCapture.positions[0] == std::make_pair(x, y));
+}
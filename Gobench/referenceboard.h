@@ -0,0 +1,41 @@
+#ifndef REFERENCEBOARD_H
+#define REFERENCEBOARD_H
+
+#include "goboard.h"
+
+// 参考实现：保留客户端最初的规则代码（BFS、每次调用分配访问表），
+// 只用于基准对比与差分校验，不追求速度
+class ReferenceBoard
+{
+public:
+    static const int BOARD_SIZE = GoBoard::BOARD_SIZE;
+    typedef GoBoard::Stone Stone;
+    static constexpr Stone EMPTY = GoBoard::EMPTY;
+    static constexpr Stone BLACK = GoBoard::BLACK;
+    static constexpr Stone WHITE = GoBoard::WHITE;
+    typedef GoBoard::CaptureInfo CaptureInfo;
+
+    ReferenceBoard();
+
+    void clear();
+
+    Stone at(int x, int y) const { return board[x][y]; }
+    void set(int x, int y, Stone stone) { board[x][y] = stone; }
+
+    bool play(int x, int y, Stone color);
+    void pass(Stone color);
+    bool isLegalMove(int x, int y, Stone color);
+
+    bool checkAndRemoveDeadStones(int x, int y);
+    bool hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited);
+    void removeStones(const std::vector<std::pair<int, int>>& stones);
+    bool isKo(int x, int y, Stone color) const;
+
+private:
+    std::vector<std::vector<Stone>> board;
+    std::pair<int, int> lastMove;
+    CaptureInfo lastBlackCapture;
+    CaptureInfo lastWhiteCapture;
+};
+
+#endif // REFERENCEBOARD_H
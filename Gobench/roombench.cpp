@@ -0,0 +1,92 @@
+#include "roombench.h"
+#include "boardbench.h"
+#include "gameroom.h"
+#include "lobbyindex.h"
+#include "ratelimiter.h"
+
+namespace {
+volatile long long g_roomSink = 0;
+}
+
+int runRoomBenchmarks()
+{
+    GameRoom room(0);
+
+    // 空棋盘上全盘每点校验一次（轮到黑方与不轮到白方各一次）
+    printResult("GameRoom::isValidMove/all-points", "gameroom", measureNs([&] {
+        for (int x = 0; x < GameRoom::BOARD_SIZE; ++x) {
+            for (int y = 0; y < GameRoom::BOARD_SIZE; ++y) {
+                g_roomSink += room.isValidMove(x, y, GameRoom::BLACK);
+                g_roomSink += room.isValidMove(x, y, GameRoom::WHITE);
+            }
+        }
+    }));
+
+    // 大厅：五万个房间时翻页与增量更新的开销
+    const int ROOM_COUNT = 50000;
+    LobbyIndex lobby;
+    for (int id = 1; id <= ROOM_COUNT; ++id) {
+        LobbyIndex::Entry entry;
+        entry.roomId = id;
+        entry.state = (id % 10 == 0) ? LobbyIndex::Open : LobbyIndex::InProgress;
+        entry.players = (entry.state == LobbyIndex::Open) ? 1 : 2;
+        lobby.upsert(entry);
+    }
+    int failures = 0;
+    int next = 0;
+    QList<LobbyIndex::Entry> first = lobby.page(LobbyIndex::OpenRooms, 0, 20, &next);
+    if (first.size() != 20 || first.first().roomId != 10 || next != 200
+        || lobby.count(LobbyIndex::OpenRooms) != ROOM_COUNT / 10) {
+        std::printf("FAIL lobby page\n");
+        ++failures;
+    }
+
+    int cursor = 0;
+    printResult("LobbyIndex::page/50k-rooms-20", "lobby", measureNs([&] {
+        QList<LobbyIndex::Entry> page = lobby.page(LobbyIndex::SpectatableRooms, cursor, 20, &cursor);
+        g_roomSink += page.size();
+    }));
+    int toggle = 0;
+    printResult("LobbyIndex::upsert/50k-rooms", "lobby", measureNs([&] {
+        LobbyIndex::Entry entry = lobby.entry(ROOM_COUNT / 2);
+        entry.spectators = (++toggle) % 2;
+        lobby.upsert(entry);
+    }));
+
+    // 限流：令牌桶的积攒上限、补充与等待时间，以及速率为0时不限制
+    TokenBucket bucket(10, 5, 0);
+    bool bucketOk = true;
+    for (int i = 0; i < 5; ++i) {
+        bucketOk = bucketOk && bucket.consume(1, 0);
+    }
+    bucketOk = bucketOk && !bucket.consume(1, 0) && bucket.msUntil(1, 0) == 100
+        && !bucket.consume(1, 99) && bucket.consume(1, 100) && !bucket.consume(1, 100)
+        && !bucket.consume(3, 300) && bucket.available(300) == 2
+        && bucket.available(10000) == 5 && bucket.isFull(10000)
+        && bucket.available(5000) == 5;
+    TokenBucket unlimited(0, 0, 0);
+    bucketOk = bucketOk && unlimited.consume(1e9, 0) && unlimited.msUntil(1e9, 0) == 0;
+    if (!bucketOk) {
+        std::printf("FAIL token bucket\n");
+        ++failures;
+    }
+
+    // 丢弃计数：按秒衰减到0为止，衰减为0时只增不减
+    DecayingCounter violations(1, 0);
+    DecayingCounter sticky(0, 0);
+    if (violations.add(3, 0) != 3 || violations.value(1000) != 2 || violations.value(500) != 2
+        || violations.value(10000) != 0 || violations.add(1, 10000) != 1
+        || sticky.add(3, 0) != 3 || sticky.value(1000000) != 3) {
+        std::printf("FAIL decaying counter\n");
+        ++failures;
+    }
+
+    // 每条消息都要取一次令牌：时间前进半个令牌的量，交替成功与失败
+    TokenBucket messages(20, 40, 0);
+    qint64 now = 0;
+    printResult("TokenBucket::consume", "ratelimiter", measureNs([&] {
+        now += 25;
+        g_roomSink += messages.consume(1, now);
+    }));
+    return failures;
+}
@@ -0,0 +1,7 @@
+#ifndef ROOMBENCH_H
+#define ROOMBENCH_H
+
+// 服务器端 GameRoom 的校验开销
+int runRoomBenchmarks();
+
+#endif // ROOMBENCH_H
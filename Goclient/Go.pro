@@ -8,11 +8,21 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+INCLUDEPATH += ../Gocommon
+
 SOURCES += \
+    ../Gocommon/goboard.cpp \
+    ../Gocommon/goprotocol.cpp \
+    influencemap.cpp \
+    influenceworker.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
+    ../Gocommon/goboard.h \
+    ../Gocommon/goprotocol.h \
+    influencemap.h \
+    influenceworker.h \
     mainwindow.h
 
 FORMS += \
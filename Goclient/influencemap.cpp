@@ -0,0 +1,118 @@
+#include "influencemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 归属 = 影响力 / (|影响力| + SOFTNESS)，越小越“敢”判断
+const float SOFTNESS = 0.5f;
+// 归属绝对值超过该值才算作一方的地
+const float TERRITORY_THRESHOLD = 0.4f;
+
+int classify(float owner)
+{
+    if (owner > TERRITORY_THRESHOLD) return 1;
+    if (owner < -TERRITORY_THRESHOLD) return -1;
+    return 0;
+}
+}
+
+InfluenceMap::InfluenceMap()
+{
+    // 核：1 / (1 + d²)，半径外为0
+    for (int dx = -RADIUS; dx <= RADIUS; ++dx) {
+        for (int dy = -RADIUS; dy <= RADIUS; ++dy) {
+            int d2 = dx * dx + dy * dy;
+            m_kernel[dx + RADIUS][dy + RADIUS] =
+                (d2 <= RADIUS * RADIUS) ? 1.0f / (1.0f + d2) : 0.0f;
+        }
+    }
+    clear();
+}
+
+void InfluenceMap::clear()
+{
+    std::fill(std::begin(m_field), std::end(m_field), 0.0f);
+    std::fill(std::begin(m_ownership), std::end(m_ownership), 0.0f);
+    std::fill(std::begin(m_stones), std::end(m_stones), GoBoard::EMPTY);
+    m_blackPoints = 0;
+    m_whitePoints = 0;
+}
+
+InfluenceMap::Rect InfluenceMap::apply(const std::vector<StoneChange>& changes)
+{
+    // 先把旧归属从地数中扣除，再叠加核，最后重算同一区域
+    Rect dirty;
+    for (const StoneChange& change : changes) {
+        dirty.x0 = std::min(dirty.x0, std::max(0, change.x - RADIUS));
+        dirty.y0 = std::min(dirty.y0, std::max(0, change.y - RADIUS));
+        dirty.x1 = std::max(dirty.x1, std::min(BOARD_SIZE - 1, change.x + RADIUS));
+        dirty.y1 = std::max(dirty.y1, std::min(BOARD_SIZE - 1, change.y + RADIUS));
+    }
+    if (dirty.isEmpty())
+        return dirty;
+
+    for (int x = dirty.x0; x <= dirty.x1; ++x) {
+        for (int y = dirty.y0; y <= dirty.y1; ++y) {
+            int c = classify(m_ownership[x * BOARD_SIZE + y]);
+            m_blackPoints -= (c > 0);
+            m_whitePoints -= (c < 0);
+        }
+    }
+
+    for (const StoneChange& change : changes) {
+        if (change.before == change.after)
+            continue;
+        if (change.before != GoBoard::EMPTY)
+            addKernel(change.x, change.y, change.before == GoBoard::BLACK ? -1.0f : 1.0f);
+        if (change.after != GoBoard::EMPTY)
+            addKernel(change.x, change.y, change.after == GoBoard::BLACK ? 1.0f : -1.0f);
+        m_stones[change.x * BOARD_SIZE + change.y] = change.after;
+    }
+
+    updateOwnership(dirty);
+    return dirty;
+}
+
+void InfluenceMap::addKernel(int x, int y, float sign)
+{
+    int y0 = std::max(0, y - RADIUS);
+    int y1 = std::min(BOARD_SIZE - 1, y + RADIUS);
+    int count = y1 - y0 + 1;
+
+    for (int dx = -RADIUS; dx <= RADIUS; ++dx) {
+        int nx = x + dx;
+        if (nx < 0 || nx >= BOARD_SIZE)
+            continue;
+        // 每行是连续内存，编译器可直接向量化
+        float* row = m_field + nx * BOARD_SIZE + y0;
+        const float* k = m_kernel[dx + RADIUS] + (y0 - (y - RADIUS));
+        for (int i = 0; i < count; ++i) {
+            row[i] += sign * k[i];
+        }
+    }
+}
+
+void InfluenceMap::updateOwnership(const Rect& dirty)
+{
+    int count = dirty.y1 - dirty.y0 + 1;
+    for (int x = dirty.x0; x <= dirty.x1; ++x) {
+        const float* field = m_field + x * BOARD_SIZE + dirty.y0;
+        float* owner = m_ownership + x * BOARD_SIZE + dirty.y0;
+        const GoBoard::Stone* stones = m_stones + x * BOARD_SIZE + dirty.y0;
+
+        for (int i = 0; i < count; ++i) {
+            owner[i] = field[i] / (std::fabs(field[i]) + SOFTNESS);
+        }
+        // 有子的点直接归属于该子
+        for (int i = 0; i < count; ++i) {
+            if (stones[i] == GoBoard::BLACK) owner[i] = 1.0f;
+            else if (stones[i] == GoBoard::WHITE) owner[i] = -1.0f;
+        }
+        for (int i = 0; i < count; ++i) {
+            int c = classify(owner[i]);
+            m_blackPoints += (c > 0);
+            m_whitePoints += (c < 0);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef INFLUENCEMAP_H
+#define INFLUENCEMAP_H
+
+#include "goboard.h"
+
+// 势力/形势估计：每颗棋子按距离衰减向四周辐射影响力（黑正白负），
+// 线性叠加，因此落子或提子时只需在受影响的区域加减一个核
+class InfluenceMap
+{
+public:
+    static const int BOARD_SIZE = GoBoard::BOARD_SIZE;
+    static const int RADIUS = 4;                    // 影响半径
+    static const int KERNEL_SIZE = RADIUS * 2 + 1;
+
+    // 一个点上的变化（提子、落子、回滚都表示为前后颜色）
+    struct StoneChange {
+        int x = 0;
+        int y = 0;
+        GoBoard::Stone before = GoBoard::EMPTY;
+        GoBoard::Stone after = GoBoard::EMPTY;
+    };
+
+    // 需要重画的区域（闭区间）
+    struct Rect {
+        int x0 = BOARD_SIZE, y0 = BOARD_SIZE, x1 = -1, y1 = -1;
+        bool isEmpty() const { return x0 > x1 || y0 > y1; }
+    };
+
+    InfluenceMap();
+
+    // 清空为空棋盘
+    void clear();
+    // 应用一批变化，只重算受影响区域的归属，返回该区域
+    Rect apply(const std::vector<StoneChange>& changes);
+
+    // 每点归属，范围 [-1, 1]：正为黑，负为白
+    const float* ownership() const { return m_ownership; }
+    float ownershipAt(int x, int y) const { return m_ownership[x * BOARD_SIZE + y]; }
+
+    // 按归属估算双方的地（含棋子）
+    int blackPoints() const { return m_blackPoints; }
+    int whitePoints() const { return m_whitePoints; }
+
+private:
+    float m_kernel[KERNEL_SIZE][KERNEL_SIZE];
+    float m_field[BOARD_SIZE * BOARD_SIZE];       // 叠加后的影响力
+    float m_ownership[BOARD_SIZE * BOARD_SIZE];
+    GoBoard::Stone m_stones[BOARD_SIZE * BOARD_SIZE];
+    int m_blackPoints;
+    int m_whitePoints;
+
+    // 在 (x, y) 处加上 sign 倍的核
+    void addKernel(int x, int y, float sign);
+    // 重算 dirty 区域的归属与双方地数
+    void updateOwnership(const Rect& dirty);
+};
+
+#endif // INFLUENCEMAP_H
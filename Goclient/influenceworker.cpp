@@ -0,0 +1,23 @@
+#include "influenceworker.h"
+#include <QElapsedTimer>
+#include <QDebug>
+
+InfluenceWorker::InfluenceWorker(QObject *parent) : QObject(parent) {}
+
+void InfluenceWorker::applyChanges(const QVector<InfluenceMap::StoneChange> &changes)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    map.apply(std::vector<InfluenceMap::StoneChange>(changes.begin(), changes.end()));
+
+    const int size = InfluenceMap::BOARD_SIZE * InfluenceMap::BOARD_SIZE;
+    QVector<float> ownership(map.ownership(), map.ownership() + size);
+
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+    if (elapsedUs > FRAME_BUDGET_US) {
+        qDebug() << "形势判断超出一帧：" << elapsedUs << "us，变化" << changes.size() << "点";
+    }
+
+    emit ownershipReady(ownership, map.blackPoints(), map.whitePoints());
+}
@@ -0,0 +1,31 @@
+#ifndef INFLUENCEWORKER_H
+#define INFLUENCEWORKER_H
+
+#include <QObject>
+#include <QVector>
+#include "influencemap.h"
+
+Q_DECLARE_METATYPE(InfluenceMap::StoneChange)
+
+// 在后台线程中维护形势估计，界面线程只发送棋盘变化、接收结果
+class InfluenceWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit InfluenceWorker(QObject *parent = nullptr);
+
+    // 单次更新的时间预算（一帧，微秒）
+    static const int FRAME_BUDGET_US = 16000;
+
+public slots:
+    void applyChanges(const QVector<InfluenceMap::StoneChange> &changes);
+
+signals:
+    // ownership 为整盘归属（x * BOARD_SIZE + y），正为黑，负为白
+    void ownershipReady(const QVector<float> &ownership, int blackPoints, int whitePoints);
+
+private:
+    InfluenceMap map;
+};
+
+#endif // INFLUENCEWORKER_H
@@ -13,30 +13,46 @@ MainWindow::MainWindow(QWidget *parent)
     // TCP连接
     socket->connectToHost("127.0.0.1", 1234);
     connect(socket, &QTcpSocket::connected, this, &MainWindow::onConnected);
+    connect(socket, &QTcpSocket::disconnected, this, &MainWindow::onDisconnected);
     connect(socket, &QTcpSocket::readyRead, this, &MainWindow::readServer);
+    // 未连接时定期重连（服务器重启或热备接管）
+    connect(&reconnectTimer, &QTimer::timeout, this, &MainWindow::tryReconnect);
+    reconnectTimer.start(RECONNECT_INTERVAL_MS);
 
     // 窗口尺寸计算
     int totalWidth = MARGIN * 2 + CELL_SIZE * (BOARD_SIZE - 1) + RIGHT_PANEL_WIDTH;
     int totalHeight = MARGIN * 2 + CELL_SIZE * (BOARD_SIZE - 1);
     setFixedSize(totalWidth, totalHeight);
 
-    // 初始化棋盘
-    board.resize(BOARD_SIZE, std::vector<Stone>(BOARD_SIZE, EMPTY));
-
     // 初始化button等
     QPushButton *btn_over = new QPushButton("申请数子", this);
     btn_over->setGeometry(700, MARGIN, 120, 30);
     connect(btn_over, &QPushButton::clicked, this, &MainWindow::onBtnOver);
 
+    QPushButton *btn_influence = new QPushButton("形势判断", this);
+    btn_influence->setGeometry(700, MARGIN + 40, 120, 30);
+    btn_influence->setCheckable(true);
+    connect(btn_influence, &QPushButton::toggled, this, &MainWindow::onBtnInfluence);
+
+    // 形势判断放到后台线程，落子时只发送变化的点
+    qRegisterMetaType<QVector<InfluenceMap::StoneChange>>();
+    qRegisterMetaType<QVector<float>>();
+    influenceBoard.assign(BOARD_SIZE * BOARD_SIZE, EMPTY);
+    influenceWorker = new InfluenceWorker;
+    influenceWorker->moveToThread(&influenceThread);
+    connect(&influenceThread, &QThread::finished, influenceWorker, &QObject::deleteLater);
+    connect(this, &MainWindow::boardChanged, influenceWorker, &InfluenceWorker::applyChanges);
+    connect(influenceWorker, &InfluenceWorker::ownershipReady, this, &MainWindow::onOwnershipReady);
+    influenceThread.start();
+
     myColor = EMPTY;  // 初始化为未分配，等待服务器分配
     currentTurn = BLACK;  // 黑方先行
-    lastMove = {-1, -1};
-    lastBlackCapture.count = 0;
-    lastWhiteCapture.count = 0;
 }
 
 MainWindow::~MainWindow()
 {
+    influenceThread.quit();
+    influenceThread.wait();
     delete ui;
 }
 
@@ -98,13 +114,39 @@ void MainWindow::paintEvent(QPaintEvent *event)
             );
     }
 
+    // 形势判断：空点上画半透明方块，颜色表示归属，深浅表示把握
+    if (showInfluence && ownership.size() == BOARD_SIZE * BOARD_SIZE) {
+        painter.setPen(Qt::NoPen);
+        for (int i = 0; i < BOARD_SIZE; ++i) {
+            for (int j = 0; j < BOARD_SIZE; ++j) {
+                float owner = ownership[i * BOARD_SIZE + j];
+                if (board.at(i, j) != EMPTY || std::fabs(owner) < 0.1f)
+                    continue;
+                QColor color = (owner > 0) ? Qt::black : Qt::white;
+                color.setAlpha(static_cast<int>(std::fabs(owner) * 160));
+                painter.setBrush(color);
+                painter.drawRect(
+                    MARGIN + i * CELL_SIZE - CELL_SIZE/4,
+                    MARGIN + j * CELL_SIZE - CELL_SIZE/4,
+                    CELL_SIZE/2, CELL_SIZE/2
+                    );
+            }
+        }
+    }
+
     // 绘制棋子（根据棋盘状态）
     for (int i = 0; i < BOARD_SIZE; ++i) {
         for (int j = 0; j < BOARD_SIZE; ++j) {
-            if (board[i][j] != EMPTY) {
-                QColor color = (board[i][j] == BLACK) ? Qt::black : Qt::white;
+            if (board.at(i, j) != EMPTY) {
+                QColor color = (board.at(i, j) == BLACK) ? Qt::black : Qt::white;
+                QPen pen(Qt::gray, 1);
+                // 尚未被服务器确认的落子画成半透明
+                if (pending.active && pending.x == i && pending.y == j) {
+                    color.setAlpha(120);
+                    pen.setStyle(Qt::DashLine);
+                }
                 painter.setBrush(color);
-                painter.setPen(QPen(Qt::gray, 1));
+                painter.setPen(pen);
 
                 // 棋子居中绘制
                 painter.drawEllipse(
@@ -132,53 +174,100 @@ void MainWindow::mousePressEvent(QMouseEvent *event)
             QMessageBox::information(this, "提示", "不是你的回合");
             return;
         }
-        if (!isValidPosition(x, y) || board[x][y] != EMPTY) {
+        if (!GoBoard::isValidPosition(x, y) || board.at(x, y) != EMPTY) {
             return;  // 位置不合法或已有棋子
         }
         // 劫争判断
-        if (isKo(x, y)) {
+        if (board.isKo(x, y, myColor)) {
             QMessageBox::information(this, "提示", "这是劫争，需先在其他地方落子");
             return;
         }
 
-        // 自己落子（用 myColor 表示自身颜色，固定不变）
-        board[x][y] = myColor;
-        // 检查提子
-        checkAndRemoveDeadStones(x, y);
+        // 自己落子（用 myColor 表示自身颜色，固定不变），同时检查提子；
+        // 先在本地显示，等服务器确认后再定下来
+        GoBoard before = board;
+        if (!board.play(x, y, myColor)) {
+            return;  // 自杀棋，不发送
+        }
+        pending.active = true;
+        pending.seq = nextSeq++;
+        pending.x = x;
+        pending.y = y;
+        pending.before = before;
+
         // 发送落子信息给服务器
-        QJsonObject obj;
-        obj["x"] = x;
-        obj["y"] = y;
-        socket->write(QJsonDocument(obj).toJson());
+        sendMessage(QJsonObject{{"type", "move"}, {"seq", pending.seq}, {"x", x}, {"y", y}});
 
         // 切换回合（当前回合交给对方）
         currentTurn = (myColor == BLACK) ? WHITE : BLACK;
         // 重绘棋盘
+        syncInfluence();
         update();
     }
 }
 
-// TCP连接后回调函数
+// TCP连接后回调函数：有会话则恢复对局，否则请求匹配
 void MainWindow::onConnected(){
+    if (!sessionToken.isEmpty()) {
+        sendMessage(QJsonObject{{"type", "resume"}, {"room", sessionRoom}, {"token", sessionToken}});
+    } else {
+        sendMessage(QJsonObject{{"type", "join"}});
+    }
+}
 
+void MainWindow::onDisconnected()
+{
+    readBuffer.clear();
+    statusBar()->showMessage("与服务器断开，正在重连……");
+}
+
+void MainWindow::tryReconnect()
+{
+    if (socket->state() == QAbstractSocket::UnconnectedState) {
+        socket->connectToHost("127.0.0.1", 1234);
+    }
 }
 
 void MainWindow::readServer()
 {
-    QByteArray data = socket->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull()) {
+    readBuffer.append(socket->readAll());
+    int invalid = 0;
+    const QList<QJsonObject> messages = GoProtocol::takeMessages(readBuffer, &invalid);
+    if (invalid > 0) {
         qDebug() << "无效的服务器消息";
+    }
+    for (const QJsonObject& obj : messages) {
+        handleServerMessage(obj);
+    }
+}
+
+void MainWindow::handleServerMessage(const QJsonObject &obj)
+{
+    // 先按 type 分发：resumed、move 等消息也可能带 "color"
+    QString type = obj["type"].toString();
+
+    // 断线重连
+    if (type == "resumed") {
+        handleResumed(obj);
+        return;
+    }
+    if (type == "resume_failed") {
+        // 对局已不存在：放弃会话，重新匹配
+        sessionRoom = 0;
+        sessionToken.clear();
+        myColor = EMPTY;
+        pending.active = false;
+        board.clear();
+        syncInfluence();
+        statusBar()->showMessage("原对局已无法恢复，重新匹配", 3000);
+        sendMessage(QJsonObject{{"type", "join"}});
+        update();
         return;
     }
-    QJsonObject obj = doc.object();
 
-    // 1. 处理服务器分配颜色（仅第一次连接时）
-    if (obj.contains("color")) {
-        QString color = obj["color"].toString();
-        myColor = (color == "black") ? BLACK : WHITE;  // 固定自己的颜色
-        currentTurn = BLACK;  // 黑方先行
-        update();  // 刷新界面显示自己的颜色
+    // 1. 服务器对自己落子的确认
+    if (type == "ack") {
+        handleAck(obj);
         return;
     }
 
@@ -192,154 +281,141 @@ void MainWindow::readServer()
     //     }
     // }
     // 2. 处理对方落子（完全独立于本地鼠标事件）
-    if (obj.contains("x") && obj.contains("y")) {
+    if (type == "move") {
         int x = obj["x"].toInt();
         int y = obj["y"].toInt();
         // 对方颜色 = 与自己颜色相反
         Stone opponentColor = (myColor == BLACK) ? WHITE : BLACK;
 
-        // 直接在本地棋盘绘制对方的棋子（不依赖任何本地鼠标事件）
-        if (isValidPosition(x, y) && board[x][y] == EMPTY) {
-            board[x][y] = opponentColor;
-            // 检查对方落子后的提子（对方可能提掉自己的子）
-            checkAndRemoveDeadStones(x, y);
+        // 服务器已校验过，直接按其提子结果更新本地棋盘（坐标越界的消息被忽略）
+        if (board.applyMove(x, y, opponentColor, GoProtocol::pointsFromJson(obj["captures"].toArray()))) {
             // 切换回合（当前回合交给自己）
             currentTurn = myColor;
             // 强制重绘，显示对方的落子
+            syncInfluence();
             update();
         }
     }
-}
-
-// 申请数子
-void MainWindow::onBtnOver(){
 
+    // 3. 处理服务器分配颜色（仅第一次连接时，消息不带 type）
+    if (type.isEmpty() && obj.contains("color")) {
+        QString color = obj["color"].toString();
+        myColor = (color == "black") ? BLACK : WHITE;  // 固定自己的颜色
+        currentTurn = BLACK;  // 黑方先行
+        sessionRoom = obj["room"].toInt();
+        sessionToken = obj["token"].toString();
+        update();  // 刷新界面显示自己的颜色
+    }
 }
 
-// 检测并移除没有气的棋子
-void MainWindow::checkAndRemoveDeadStones(int x, int y)
+void MainWindow::handleAck(const QJsonObject &obj)
 {
-    Stone currentColor = board[x][y];
-    Stone opponentColor = (currentColor == BLACK) ? WHITE : BLACK;
+    if (!pending.active || obj["seq"].toInt() != pending.seq) {
+        qDebug() << "收到过期的落子确认" << obj["seq"].toInt();
+        return;
+    }
+    pending.active = false;
+
+    if (!obj["accepted"].toBool()) {
+        // 被拒绝：回滚到落子前，回合还给自己
+        board = pending.before;
+        currentTurn = myColor;
+        statusBar()->showMessage("落子未被服务器接受：" + obj["reason"].toString(), 3000);
+        syncInfluence();
+        update();
+        return;
+    }
 
-    // 存储本次提子信息
-    CaptureInfo currentCapture;
+    // 被接受：若本地提子与服务器不一致，以服务器为准重放这一手
+    std::vector<std::pair<int, int>> captures = GoProtocol::pointsFromJson(obj["captures"].toArray());
+    std::vector<std::pair<int, int>> local = board.lastCapture(myColor).positions;
+    std::sort(captures.begin(), captures.end());
+    std::sort(local.begin(), local.end());
+    if (captures != local) {
+        board = pending.before;
+        board.applyMove(pending.x, pending.y, myColor, captures);
+        syncInfluence();
+    }
+    update();
+}
 
-    // 检查四个方向的对手棋子
-    QVector<QPoint> directions = {
-        QPoint(-1, 0), QPoint(1, 0), QPoint(0, -1), QPoint(0, 1)
-    };
+// 发送消息给服务器
+void MainWindow::sendMessage(const QJsonObject &obj)
+{
+    socket->write(GoProtocol::encode(obj));
+}
 
-    for (const auto& dir : directions) {
-        int nx = x + dir.x();
-        int ny = y + dir.y();
-
-        if (isValidPosition(nx, ny) && board[nx][ny] == opponentColor) {
-            // 检查这组棋子是否有气
-            std::vector<std::pair<int, int>> visited;
-            if (!hasLiberty(nx, ny, opponentColor, visited)) {
-                // 记录被提子的位置
-                for (const auto& pos : visited) {
-                    currentCapture.positions.push_back(pos);
-                }
-                removeStones(visited);
-            }
+void MainWindow::handleResumed(const QJsonObject &obj)
+{
+    myColor = (obj["color"].toString() == "black") ? BLACK : WHITE;
+
+    // 以服务器棋谱为准重建棋盘；未被确认的落子随之丢弃
+    pending.active = false;
+    board.clear();
+    const QJsonArray moves = obj["moves"].toArray();
+    for (const QJsonValue& value : moves) {
+        QJsonArray move = value.toArray();
+        int color = move.size() == 3 ? move[2].toInt() : EMPTY;
+        // 格式不对或颜色无效的记录直接跳过（play 会拒绝棋盘外的坐标）
+        if (color != BLACK && color != WHITE) {
+            qDebug() << "无效的棋谱记录" << move;
+            continue;
         }
+        board.play(move[0].toInt(), move[1].toInt(), static_cast<Stone>(color));
     }
+    currentTurn = (moves.size() % 2 == 0) ? BLACK : WHITE;
 
-    // 更新提子数量
-    currentCapture.count = currentCapture.positions.size();
+    statusBar()->showMessage("已恢复对局", 3000);
+    syncInfluence();
+    update();
+}
 
-    // 更新对应玩家的上一次提子信息
-    if (currentColor == BLACK) {
-        lastBlackCapture = currentCapture;
+// 形势判断开关
+void MainWindow::onBtnInfluence(bool checked)
+{
+    showInfluence = checked;
+    if (checked) {
+        statusBar()->showMessage(QString("形势：黑 %1 目，白 %2 目").arg(estimateBlack).arg(estimateWhite));
     } else {
-        lastWhiteCapture = currentCapture;
+        statusBar()->clearMessage();
     }
+    update();
+}
 
-    // 检查自己是否因为落子导致被提（自杀棋）
-    std::vector<std::pair<int, int>> visitedSelf;
-    if (!hasLiberty(x, y, currentColor, visitedSelf)) {
-        // 自杀棋，回退操作
-        board[x][y] = EMPTY;
+void MainWindow::onOwnershipReady(const QVector<float> &ownership, int blackPoints, int whitePoints)
+{
+    this->ownership = ownership;
+    estimateBlack = blackPoints;
+    estimateWhite = whitePoints;
+    if (showInfluence) {
+        statusBar()->showMessage(QString("形势：黑 %1 目，白 %2 目").arg(blackPoints).arg(whitePoints));
         update();
-        return;
     }
-
-    // 记录当前落子位置
-    lastMove = {x, y};
 }
 
-// 检测一组棋子是否有气（BFS）
-bool MainWindow::hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited)
+void MainWindow::syncInfluence()
 {
-    if (!isValidPosition(x, y) || board[x][y] != color)
-        return false;
-
-    std::queue<std::pair<int, int>> q;
-    std::vector<std::vector<bool>> visitedGrid(BOARD_SIZE, std::vector<bool>(BOARD_SIZE, false));
-
-    q.push({x, y});
-    visitedGrid[x][y] = true;
-
-    while (!q.empty()) {
-        auto [cx, cy] = q.front();
-        q.pop();
-        visited.push_back({cx, cy});
-
-        // 检查四个方向
-        QVector<QPoint> directions = {
-            QPoint(-1, 0), QPoint(1, 0), QPoint(0, -1), QPoint(0, 1)
-        };
-
-        for (const auto& dir : directions) {
-            int nx = cx + dir.x();
-            int ny = cy + dir.y();
-
-            if (!isValidPosition(nx, ny))
-                continue;
-
-            if (board[nx][ny] == EMPTY) {
-                // 找到气
-                return true;
-            } else if (board[nx][ny] == color && !visitedGrid[nx][ny]) {
-                // 相连的同色棋子，加入队列
-                q.push({nx, ny});
-                visitedGrid[nx][ny] = true;
+    QVector<InfluenceMap::StoneChange> changes;
+    for (int i = 0; i < BOARD_SIZE; ++i) {
+        for (int j = 0; j < BOARD_SIZE; ++j) {
+            Stone& sent = influenceBoard[i * BOARD_SIZE + j];
+            if (board.at(i, j) != sent) {
+                InfluenceMap::StoneChange change;
+                change.x = i;
+                change.y = j;
+                change.before = sent;
+                change.after = board.at(i, j);
+                changes.append(change);
+                sent = change.after;
             }
         }
     }
-
-    // 没有找到气
-    return false;
-}
-
-// 移除一组棋子
-void MainWindow::removeStones(const std::vector<std::pair<int, int>>& stones)
-{
-    for (const auto& [x, y] : stones) {
-        board[x][y] = EMPTY;
-        update();
+    if (!changes.isEmpty()) {
+        emit boardChanged(changes);
     }
 }
 
-// 判断位置是否合法
-bool MainWindow::isValidPosition(int x, int y) const
-{
-    return x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE;
-}
+// 申请数子
+void MainWindow::onBtnOver(){
 
-// 简单劫争判断（防止无限循环提子）
-bool MainWindow::isKo(int x, int y)
-{
-    // 当前落子的是自己（myColor 固定）
-    Stone opponentColor = (myColor == BLACK) ? WHITE : BLACK;
-    // 获取对手上一次的提子信息
-    const CaptureInfo& opponentLastCapture =
-        (opponentColor == BLACK) ? lastBlackCapture : lastWhiteCapture;
-
-    // 劫争条件：对手上一次只提了1颗子，且当前位置是被提的位置
-    return (opponentLastCapture.count == 1
-            && !opponentLastCapture.positions.empty()
-            && opponentLastCapture.positions[0] == std::make_pair(x, y));
 }
@@ -7,10 +7,18 @@
 #include <QMessageBox>
 #include <vector>
 #include <queue>
+#include <algorithm>
+#include <cmath>
 #include <QTcpSocket>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QPushButton>
+#include <QStatusBar>
+#include <QThread>
+#include <QTimer>
+#include "goboard.h"
+#include "goprotocol.h"
+#include "influenceworker.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -29,54 +37,77 @@ protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
 
+signals:
+    // 发给后台线程的棋盘变化
+    void boardChanged(const QVector<InfluenceMap::StoneChange> &changes);
+
 private slots:
     void onConnected();
+    void onDisconnected();
+    void tryReconnect();
     void readServer();
     void onBtnOver();
+    void onBtnInfluence(bool checked);
+    void onOwnershipReady(const QVector<float> &ownership, int blackPoints, int whitePoints);
 
 private:
     Ui::MainWindow *ui;
-    static const int BOARD_SIZE = 19;
+    static const int BOARD_SIZE = GoBoard::BOARD_SIZE;
     static const int CELL_SIZE = 30;
     static const int MARGIN = 50;        // 左侧和顶部边距
     static const int RIGHT_PANEL_WIDTH = 200;  // 右侧面板宽度
 
-    enum Stone { EMPTY, BLACK, WHITE };
-    std::vector<std::vector<Stone>> board;
+    // 棋子类型（与共用规则保持一致）
+    typedef GoBoard::Stone Stone;
+    static constexpr Stone EMPTY = GoBoard::EMPTY;
+    static constexpr Stone BLACK = GoBoard::BLACK;
+    static constexpr Stone WHITE = GoBoard::WHITE;
+
+    // 棋盘（提子、劫争等规则由 GoBoard 负责）
+    GoBoard board;
 
     Stone myColor;
     Stone currentTurn;    // 当前轮到谁落子
 
     QTcpSocket *socket;
-
-    // 记录上一次提子信息（用于劫争判断 以及 悔棋回溯等）
-    struct CaptureInfo {
-        std::vector<std::pair<int, int>> positions;  // 被提子的位置
-        int count = 0;                               // 提子数量
-        // 显式初始化，避免未定义行为
-        CaptureInfo() : positions(), count(0) {}
+    QByteArray readBuffer;    // 尚未凑成整行的服务器数据
+
+    // 会话（开局时由服务器分配），断线或服务器切换后凭此恢复对局
+    int sessionRoom = 0;
+    QString sessionToken;
+    QTimer reconnectTimer;
+    // 重连间隔（毫秒）
+    static const int RECONNECT_INTERVAL_MS = 1000;
+
+    // 已在本地显示、等待服务器确认的落子（乐观更新，被拒绝时回滚）
+    struct PendingMove {
+        bool active = false;
+        int seq = 0;
+        int x = -1;
+        int y = -1;
+        GoBoard before;       // 落子前的棋盘，用于回滚或按权威结果重放
     };
-
-    // 记录上一步位置（用于劫争判断）
-    std::pair<int, int> lastMove;
-
-
-    CaptureInfo lastBlackCapture;  // 黑方上一次提子信息
-    CaptureInfo lastWhiteCapture;  // 白方上一次提子信息
-
-    // 检测并移除没有气的棋子
-    void checkAndRemoveDeadStones(int x, int y);
-
-    // 检测一组相连棋子的气
-    bool hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited);
-
-    // 移除一组棋子
-    void removeStones(const std::vector<std::pair<int, int>>& stones);
-
-    // 判断位置是否合法
-    bool isValidPosition(int x, int y) const;
-
-    // 检查劫争
-    bool isKo(int x, int y);
+    PendingMove pending;
+    int nextSeq = 1;          // 下一手的序号
+
+    // 发送一条消息给服务器
+    void sendMessage(const QJsonObject &obj);
+    // 处理一条完整的服务器消息
+    void handleServerMessage(const QJsonObject &obj);
+    // 处理服务器对自己落子的确认或拒绝
+    void handleAck(const QJsonObject &obj);
+    // 恢复对局：按服务器的棋谱重建棋盘
+    void handleResumed(const QJsonObject &obj);
+
+    // 形势判断（后台线程增量计算，半透明叠加显示）
+    QThread influenceThread;
+    InfluenceWorker *influenceWorker;
+    std::vector<Stone> influenceBoard;   // 已发给后台线程的棋盘
+    QVector<float> ownership;            // 最近一次的归属结果
+    int estimateBlack = 0;               // 最近一次估算的双方地数
+    int estimateWhite = 0;
+    bool showInfluence = false;
+    // 把棋盘相对上次发送时的变化交给后台线程
+    void syncInfluence();
 };
 #endif // MAINWINDOW_H
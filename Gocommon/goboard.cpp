@@ -0,0 +1,220 @@
+#include "goboard.h"
+
+#include <algorithm>
+
+namespace {
+// 四个方向
+const int DX[4] = { -1, 1, 0, 0 };
+const int DY[4] = { 0, 0, -1, 1 };
+}
+
+GoBoard::GoBoard()
+    : m_mark(BOARD_SIZE * BOARD_SIZE, 0)
+    , m_markStamp(0)
+{
+    m_stack.reserve(BOARD_SIZE * BOARD_SIZE);
+    m_scratch.reserve(BOARD_SIZE * BOARD_SIZE);
+    clear();
+}
+
+void GoBoard::clear()
+{
+    m_board.assign(BOARD_SIZE * BOARD_SIZE, EMPTY);
+    m_lastMove = {-1, -1};
+    m_lastBlackCapture = CaptureInfo();
+    m_lastWhiteCapture = CaptureInfo();
+}
+
+bool GoBoard::play(int x, int y, Stone color)
+{
+    if (color == EMPTY || !isValidPosition(x, y) || at(x, y) != EMPTY)
+        return false;
+    if (isKo(x, y, color))
+        return false;
+
+    set(x, y, color);
+    return checkAndRemoveDeadStones(x, y);
+}
+
+void GoBoard::pass(Stone color)
+{
+    if (color == BLACK) {
+        m_lastBlackCapture = CaptureInfo();
+    } else {
+        m_lastWhiteCapture = CaptureInfo();
+    }
+}
+
+bool GoBoard::applyMove(int x, int y, Stone color, const std::vector<std::pair<int, int>>& captures)
+{
+    // 数据来自网络：坐标或颜色越界时整手忽略，避免越界写入
+    if ((color != BLACK && color != WHITE) || !isValidPosition(x, y))
+        return false;
+    for (const auto& [cx, cy] : captures) {
+        if (!isValidPosition(cx, cy))
+            return false;
+    }
+
+    set(x, y, color);
+    removeStones(captures);
+
+    CaptureInfo& capture = (color == BLACK) ? m_lastBlackCapture : m_lastWhiteCapture;
+    capture.positions = captures;
+    capture.count = static_cast<int>(captures.size());
+    m_lastMove = {x, y};
+    return true;
+}
+
+bool GoBoard::isLegalMove(int x, int y, Stone color)
+{
+    if (color == EMPTY || !isValidPosition(x, y) || at(x, y) != EMPTY)
+        return false;
+    if (isKo(x, y, color))
+        return false;
+
+    // 先看是否有直接的气，避免无谓的搜索
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + DX[d];
+        int ny = y + DY[d];
+        if (isValidPosition(nx, ny) && at(nx, ny) == EMPTY)
+            return true;
+    }
+
+    set(x, y, color);
+    bool legal = false;
+    Stone opponentColor = opponent(color);
+
+    // 能提掉对方棋子即合法
+    for (int d = 0; d < 4 && !legal; ++d) {
+        int nx = x + DX[d];
+        int ny = y + DY[d];
+        if (isValidPosition(nx, ny) && at(nx, ny) == opponentColor) {
+            m_scratch.clear();
+            legal = !hasLiberty(nx, ny, opponentColor, m_scratch);
+        }
+    }
+    // 否则自身所在的棋块必须有气
+    if (!legal) {
+        m_scratch.clear();
+        legal = hasLiberty(x, y, color, m_scratch);
+    }
+
+    set(x, y, EMPTY);
+    return legal;
+}
+
+// 检测并移除没有气的棋子
+bool GoBoard::checkAndRemoveDeadStones(int x, int y)
+{
+    Stone currentColor = at(x, y);
+    Stone opponentColor = opponent(currentColor);
+
+    // 存储本次提子信息
+    CaptureInfo currentCapture;
+
+    // 检查四个方向的对手棋子
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + DX[d];
+        int ny = y + DY[d];
+
+        if (isValidPosition(nx, ny) && at(nx, ny) == opponentColor) {
+            // 检查这组棋子是否有气
+            m_scratch.clear();
+            if (!hasLiberty(nx, ny, opponentColor, m_scratch)) {
+                // 记录被提子的位置
+                currentCapture.positions.insert(currentCapture.positions.end(),
+                                                m_scratch.begin(), m_scratch.end());
+                removeStones(m_scratch);
+            }
+        }
+    }
+
+    // 检查自己是否因为落子导致被提（自杀棋）
+    m_scratch.clear();
+    if (!hasLiberty(x, y, currentColor, m_scratch)) {
+        // 自杀棋，回退操作
+        set(x, y, EMPTY);
+        return false;
+    }
+
+    // 更新提子数量
+    currentCapture.count = static_cast<int>(currentCapture.positions.size());
+
+    // 更新对应玩家的上一次提子信息
+    if (currentColor == BLACK) {
+        m_lastBlackCapture = std::move(currentCapture);
+    } else {
+        m_lastWhiteCapture = std::move(currentCapture);
+    }
+
+    // 记录当前落子位置
+    m_lastMove = {x, y};
+    return true;
+}
+
+// 检测一组棋子是否有气（深度优先，访问标记与栈跨调用复用）
+bool GoBoard::hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited)
+{
+    if (!isValidPosition(x, y) || at(x, y) != color)
+        return false;
+
+    // 递增标记值即可“清空”访问记录，溢出时才真正清零
+    if (++m_markStamp == 0) {
+        std::fill(m_mark.begin(), m_mark.end(), 0);
+        m_markStamp = 1;
+    }
+
+    m_stack.clear();
+    m_stack.push_back(x * BOARD_SIZE + y);
+    m_mark[x * BOARD_SIZE + y] = m_markStamp;
+
+    while (!m_stack.empty()) {
+        int p = m_stack.back();
+        m_stack.pop_back();
+        int cx = p / BOARD_SIZE;
+        int cy = p % BOARD_SIZE;
+        visited.push_back({cx, cy});
+
+        // 检查四个方向
+        for (int d = 0; d < 4; ++d) {
+            int nx = cx + DX[d];
+            int ny = cy + DY[d];
+
+            if (!isValidPosition(nx, ny))
+                continue;
+
+            int np = nx * BOARD_SIZE + ny;
+            if (m_board[np] == EMPTY) {
+                // 找到气
+                return true;
+            } else if (m_board[np] == color && m_mark[np] != m_markStamp) {
+                // 相连的同色棋子，加入栈
+                m_mark[np] = m_markStamp;
+                m_stack.push_back(np);
+            }
+        }
+    }
+
+    // 没有找到气
+    return false;
+}
+
+// 移除一组棋子
+void GoBoard::removeStones(const std::vector<std::pair<int, int>>& stones)
+{
+    for (const auto& [x, y] : stones) {
+        set(x, y, EMPTY);
+    }
+}
+
+// 简单劫争判断（防止无限循环提子）
+bool GoBoard::isKo(int x, int y, Stone color) const
+{
+    // 获取对手上一次的提子信息
+    const CaptureInfo& opponentLastCapture = lastCapture(opponent(color));
+
+    // 劫争条件：对手上一次只提了1颗子，且当前位置是被提的位置
+    return (opponentLastCapture.count == 1
+            && !opponentLastCapture.positions.empty()
+            && opponentLastCapture.positions[0] == std::make_pair(x, y));
+}
@@ -0,0 +1,84 @@
+#ifndef GOBOARD_H
+#define GOBOARD_H
+
+#include <vector>
+#include <utility>
+
+// 围棋规则（客户端、服务器与基准测试共用，不依赖Qt）
+class GoBoard
+{
+public:
+    // 棋盘尺寸（19×19围棋）
+    static const int BOARD_SIZE = 19;
+    // 棋子类型
+    enum Stone { EMPTY, BLACK, WHITE };
+
+    // 记录上一次提子信息（用于劫争判断 以及 悔棋回溯等）
+    struct CaptureInfo {
+        std::vector<std::pair<int, int>> positions;  // 被提子的位置
+        int count = 0;                               // 提子数量
+        // 显式初始化，避免未定义行为
+        CaptureInfo() : positions(), count(0) {}
+    };
+
+    GoBoard();
+
+    // 清空棋盘与提子记录
+    void clear();
+
+    Stone at(int x, int y) const { return m_board[x * BOARD_SIZE + y]; }
+    void set(int x, int y, Stone stone) { m_board[x * BOARD_SIZE + y] = stone; }
+
+    static Stone opponent(Stone color) { return (color == BLACK) ? WHITE : BLACK; }
+
+    // 判断位置是否合法
+    static bool isValidPosition(int x, int y)
+    {
+        return x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE;
+    }
+
+    // 落子：位置非法、已有棋子、劫争或自杀时返回false且棋盘不变
+    bool play(int x, int y, Stone color);
+    // 虚着（清除该方的提子记录，使劫争判断只看对手的上一手）
+    void pass(Stone color);
+    // 按服务器给出的结果落子并提子，不做规则校验；坐标或颜色越界时返回false且棋盘不变
+    bool applyMove(int x, int y, Stone color, const std::vector<std::pair<int, int>>& captures);
+
+    // 不改变棋盘地判断落子是否合法
+    bool isLegalMove(int x, int y, Stone color);
+
+    // 检测并移除没有气的棋子，自杀时回退落子并返回false
+    bool checkAndRemoveDeadStones(int x, int y);
+
+    // 检测一组相连棋子的气，visited 返回已搜索到的棋子
+    bool hasLiberty(int x, int y, Stone color, std::vector<std::pair<int, int>>& visited);
+
+    // 移除一组棋子
+    void removeStones(const std::vector<std::pair<int, int>>& stones);
+
+    // 检查劫争（color 为落子方）
+    bool isKo(int x, int y, Stone color) const;
+
+    const CaptureInfo& lastCapture(Stone color) const
+    {
+        return (color == BLACK) ? m_lastBlackCapture : m_lastWhiteCapture;
+    }
+    std::pair<int, int> lastMove() const { return m_lastMove; }
+
+private:
+    std::vector<Stone> m_board;
+
+    // 记录上一步位置（用于劫争判断）
+    std::pair<int, int> m_lastMove;
+
+    CaptureInfo m_lastBlackCapture;  // 黑方上一次提子信息
+    CaptureInfo m_lastWhiteCapture;  // 白方上一次提子信息
+
+    // hasLiberty 的搜索缓冲区，跨调用复用以避免每次分配
+    std::vector<unsigned> m_mark;      // 访问标记（等于 m_markStamp 即已访问）
+    unsigned m_markStamp;
+    std::vector<int> m_stack;          // 待搜索的点（x * BOARD_SIZE + y）
+    std::vector<std::pair<int, int>> m_scratch;
+};
+
+#endif // GOBOARD_H
@@ -0,0 +1,66 @@
+#include "goprotocol.h"
+#include "goboard.h"
+#include <QJsonDocument>
+
+namespace GoProtocol
+{
+
+QByteArray encode(const QJsonObject& obj)
+{
+    QByteArray data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    data.append('\n');
+    return data;
+}
+
+QList<QJsonObject> takeMessages(QByteArray& buffer, int* invalid)
+{
+    QList<QJsonObject> messages;
+    int bad = 0;
+    int start = 0;
+    int end;
+    while ((end = buffer.indexOf('\n', start)) >= 0) {
+        QByteArray line = buffer.mid(start, end - start).trimmed();
+        start = end + 1;
+        if (line.isEmpty())
+            continue;
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (doc.isNull() || !doc.isObject()) {
+            ++bad;
+            continue;
+        }
+        messages.append(doc.object());
+    }
+    buffer.remove(0, start);
+    if (invalid)
+        *invalid = bad;
+    return messages;
+}
+
+QJsonArray pointsToJson(const std::vector<std::pair<int, int>>& points)
+{
+    QJsonArray array;
+    for (const auto& [x, y] : points) {
+        array.append(QJsonArray{x, y});
+    }
+    return array;
+}
+
+std::vector<std::pair<int, int>> pointsFromJson(const QJsonArray& array)
+{
+    std::vector<std::pair<int, int>> points;
+    points.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        QJsonArray p = value.toArray();
+        if (p.size() != 2 || !p[0].isDouble() || !p[1].isDouble())
+            continue;
+        int x = p[0].toInt();
+        int y = p[1].toInt();
+        // 丢弃棋盘外的点
+        if (GoBoard::isValidPosition(x, y)) {
+            points.push_back({x, y});
+        }
+    }
+    return points;
+}
+
+}
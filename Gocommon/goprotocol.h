@@ -0,0 +1,26 @@
+#ifndef GOPROTOCOL_H
+#define GOPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <vector>
+#include <utility>
+
+// 客户端与服务器之间的消息格式：每条消息是一行紧凑JSON，以 '\n' 结尾
+namespace GoProtocol
+{
+// 编码一条消息
+QByteArray encode(const QJsonObject& obj);
+
+// 从接收缓冲区取出所有完整的消息，不完整的尾部留在缓冲区中；
+// invalid 返回无法解析的行数
+QList<QJsonObject> takeMessages(QByteArray& buffer, int* invalid = nullptr);
+
+// 坐标列表 <-> [[x, y], ...]（解析时丢弃格式不对或在棋盘外的点）
+QJsonArray pointsToJson(const std::vector<std::pair<int, int>>& points);
+std::vector<std::pair<int, int>> pointsFromJson(const QJsonArray& array);
+}
+
+#endif // GOPROTOCOL_H
@@ -0,0 +1,90 @@
+#include "patterntable.h"
+#include <algorithm>
+
+namespace {
+// 正交邻点与对角邻点在编码中的序号
+const int ORTHOGONAL[4] = { 1, 3, 4, 6 };
+const int DIAGONAL[4] = { 0, 2, 5, 7 };
+
+int weightFor(int code, int own)
+{
+    int opponent = 3 - own;
+    int ownOrth = 0, oppOrth = 0, offOrth = 0;
+    int ownDiag = 0, oppDiag = 0, offAll = 0;
+    for (int k : ORTHOGONAL) {
+        int f = PatternTable::field(code, k);
+        ownOrth += (f == own);
+        oppOrth += (f == opponent);
+        offOrth += (f == PatternTable::FIELD_OFF);
+    }
+    for (int k : DIAGONAL) {
+        int f = PatternTable::field(code, k);
+        ownDiag += (f == own);
+        oppDiag += (f == opponent);
+        offAll += (f == PatternTable::FIELD_OFF);
+    }
+    offAll += offOrth;
+
+    // 己方眼位（四周只有己方棋子或盘外）：不填
+    if (ownOrth + offOrth == 4)
+        return 0;
+    // 对方眼位：只有提子时才合法，合法时通常是好棋
+    if (oppOrth + offOrth == 4)
+        return 60;
+    // 周围没有棋子：一线少下，其余均匀
+    if (ownOrth + oppOrth + ownDiag + oppDiag == 0)
+        return offAll > 0 ? 2 : 10;
+    // 贴近对方棋子的着手（靠、扳、断）权重更高
+    int weight = 10 + 12 * oppOrth + 6 * ownOrth + 4 * oppDiag + 2 * ownDiag;
+    return std::min(weight, 255);
+}
+}
+
+PatternTable::PatternTable()
+    : m_builtin(TABLE_BYTES)
+{
+    generate(m_builtin.data());
+    m_data = m_builtin.data();
+}
+
+void PatternTable::generate(uint8_t *out)
+{
+    for (int color = 1; color <= 2; ++color) {
+        uint8_t* table = out + (color - 1) * PATTERN_COUNT;
+        for (int code = 0; code < PATTERN_COUNT; ++code) {
+            table[code] = static_cast<uint8_t>(weightFor(code, color));
+        }
+    }
+}
+
+bool PatternTable::open(const QString &path)
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+        m_file.close();
+        m_data = m_builtin.data();
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.exists()) {
+        if (!m_file.open(QIODevice::WriteOnly))
+            return false;
+        m_file.write(reinterpret_cast<const char*>(m_builtin.data()), TABLE_BYTES);
+        m_file.close();
+    }
+
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    if (m_file.size() != TABLE_BYTES) {
+        m_file.close();
+        return false;
+    }
+    m_mapped = m_file.map(0, TABLE_BYTES);
+    if (!m_mapped) {
+        m_file.close();
+        return false;
+    }
+    m_data = m_mapped;
+    return true;
+}
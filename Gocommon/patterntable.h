@@ -0,0 +1,44 @@
+#ifndef PATTERNTABLE_H
+#define PATTERNTABLE_H
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+// 3×3 模式权重表：以一点周围8个邻点的颜色（各2位：空/黑/白/盘外）为16位编码，
+// 分别为黑、白两方给出落子权重（0 表示随机对局中不下）。
+// 文件格式即两张连续的 65536 字节表（先黑后白），可用 open() 直接内存映射
+class PatternTable
+{
+public:
+    static const int PATTERN_COUNT = 1 << 16;
+    static const int TABLE_BYTES = PATTERN_COUNT * 2;
+
+    // 邻点颜色编码
+    enum Field { FIELD_EMPTY = 0, FIELD_BLACK = 1, FIELD_WHITE = 2, FIELD_OFF = 3 };
+    // 邻点顺序（dx, dy）：(-1,-1) (-1,0) (-1,1) (0,-1) (0,1) (1,-1) (1,0) (1,1)，
+    // 第 k 个邻点占第 2k、2k+1 位；k 与 7-k 互为反方向
+    static int field(int code, int k) { return (code >> (2 * k)) & 3; }
+
+    // 默认使用内置表（不读文件）
+    PatternTable();
+
+    // 映射权重文件；文件不存在时先用内置表生成。失败时保留内置表并返回 false
+    bool open(const QString& path);
+    bool isMapped() const { return m_mapped != nullptr; }
+
+    // color 为 1（黑）或 2（白）
+    const uint8_t* weights(int color) const { return m_data + (color - 1) * PATTERN_COUNT; }
+
+    // 生成内置的手工权重：不填己方眼，偏好贴近棋子的着手与可能的提子
+    static void generate(uint8_t* out);
+
+private:
+    std::vector<uint8_t> m_builtin;
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    const uint8_t* m_data;
+};
+
+#endif // PATTERNTABLE_H
@@ -0,0 +1,345 @@
+#include "playoutboard.h"
+#include <utility>
+
+namespace {
+const int OFF = PatternTable::FIELD_OFF;
+const int W = PlayoutBoard::W;
+// 四个正交方向
+const int DIR4[4] = { -W, -1, 1, W };
+// 8个邻点，顺序与 PatternTable 的编码一致
+const int DIR8[8] = { -W - 1, -W, -W + 1, -1, 1, W - 1, W, W + 1 };
+}
+
+PlayoutBoard::PlayoutBoard(const PatternTable &table)
+    : m_table(&table)
+{
+    clear();
+}
+
+void PlayoutBoard::clear()
+{
+    m_koPoint = -1;
+    for (int p = 0; p < POINTS; ++p) {
+        int x = p / W - 1, y = p % W - 1;
+        m_color[p] = GoBoard::isValidPosition(x, y) ? GoBoard::EMPTY : OFF;
+        m_head[p] = p;
+        m_next[p] = p;
+        m_liberties[p] = 0;
+        m_size[p] = 0;
+    }
+    for (int p = 0; p < POINTS; ++p) {
+        m_pattern[p] = 0;
+        if (m_color[p] == OFF)
+            continue;
+        for (int k = 0; k < 8; ++k) {
+            m_pattern[p] |= m_color[p + DIR8[k]] << (2 * k);
+        }
+    }
+
+    for (int side = 0; side < 2; ++side) {
+        m_totalWeight[side] = 0;
+        for (int row = 0; row < W; ++row)
+            m_rowWeight[side][row] = 0;
+        for (int p = 0; p < POINTS; ++p)
+            m_weight[side][p] = 0;
+    }
+    for (int p = 0; p < POINTS; ++p)
+        updateWeight(p);
+}
+
+void PlayoutBoard::load(const GoBoard &board, Stone toMove)
+{
+    clear();
+    for (int x = 0; x < N; ++x) {
+        for (int y = 0; y < N; ++y) {
+            if (board.at(x, y) != GoBoard::EMPTY)
+                place(index(x, y), board.at(x, y));
+        }
+    }
+    const GoBoard::CaptureInfo& capture = board.lastCapture(GoBoard::opponent(toMove));
+    if (capture.count == 1) {
+        m_koPoint = index(capture.positions[0].first, capture.positions[0].second);
+    }
+}
+
+int PlayoutBoard::pseudoLiberties(int x, int y) const
+{
+    int p = index(x, y);
+    if (m_color[p] != GoBoard::BLACK && m_color[p] != GoBoard::WHITE)
+        return 0;
+    return m_liberties[m_head[p]];
+}
+
+// 改变一点的颜色，同时维护它与8个邻点的模式编码和权重
+void PlayoutBoard::setColor(int p, int color)
+{
+    m_color[p] = uint8_t(color);
+
+    for (int k = 0; k < 8; ++k) {
+        // 从邻点看，p 在反方向 7-k
+        int q = p + DIR8[k];
+        int shift = 2 * (7 - k);
+        m_pattern[q] = uint16_t((m_pattern[q] & ~(3 << shift)) | (color << shift));
+        // 棋子与盘外的权重恒为0，只需重新查空点
+        if (m_color[q] == GoBoard::EMPTY)
+            updateWeight(q);
+    }
+    updateWeight(p);
+}
+
+// 按当前颜色与模式编码重新查表（盘外与非空点权重为0）
+void PlayoutBoard::updateWeight(int p)
+{
+    bool empty = (m_color[p] == GoBoard::EMPTY);
+    for (int side = 0; side < 2; ++side) {
+        setWeight(side, p, empty ? m_table->weights(side + 1)[m_pattern[p]] : 0);
+    }
+}
+
+void PlayoutBoard::setWeight(int side, int p, int weight)
+{
+    int delta = weight - m_weight[side][p];
+    m_weight[side][p] = weight;
+    m_rowWeight[side][p / W] += delta;
+    m_totalWeight[side] += delta;
+}
+
+// 按权重随机选一个点（调用前须保证总权重大于0）
+int PlayoutBoard::sample(int side, Random &random) const
+{
+    int r = int(random.below(uint32_t(m_totalWeight[side])));
+    int row = 1;
+    while (r >= m_rowWeight[side][row]) {
+        r -= m_rowWeight[side][row];
+        ++row;
+    }
+    int p = row * W + 1;
+    while (r >= m_weight[side][p]) {
+        r -= m_weight[side][p];
+        ++p;
+    }
+    return p;
+}
+
+// 合法性：有空邻点；或与一个落子后仍有气的己方串相连；或能提掉对方一串。
+// 伪气数减去该串与 p 的邻接数即为落子后该串剩余的伪气，为0即无气
+bool PlayoutBoard::isLegalAt(int p, Stone color) const
+{
+    if (m_color[p] != GoBoard::EMPTY || p == m_koPoint)
+        return false;
+
+    int heads[4];
+    for (int d = 0; d < 4; ++d) {
+        int n = p + DIR4[d];
+        if (m_color[n] == GoBoard::EMPTY)
+            return true;
+        heads[d] = (m_color[n] == OFF) ? -1 : m_head[n];
+    }
+
+    for (int d = 0; d < 4; ++d) {
+        int h = heads[d];
+        if (h < 0)
+            continue;
+        int contacts = 0;
+        for (int e = 0; e < 4; ++e) {
+            contacts += (heads[e] == h);
+        }
+        int remaining = m_liberties[h] - contacts;
+        if (m_color[h] == color ? remaining > 0 : remaining == 0)
+            return true;
+    }
+    return false;
+}
+
+// 劫形的提子：落子点四周都是对方棋子或盘外，且恰好提掉对方一颗单子
+// （落下的子只剩被提的那一口气，对方随即可以反提）
+bool PlayoutBoard::isKoCaptureAt(int p, Stone color) const
+{
+    Stone opponent = GoBoard::opponent(color);
+    int heads[4];
+    int headCount = 0;
+    int captured = 0;
+    for (int d = 0; d < 4; ++d) {
+        int n = p + DIR4[d];
+        if (m_color[n] == OFF)
+            continue;
+        if (m_color[n] != opponent)
+            return false;
+        int h = m_head[n];
+        bool seen = false;
+        for (int i = 0; i < headCount; ++i) {
+            seen |= (heads[i] == h);
+        }
+        if (seen)
+            continue;
+        heads[headCount++] = h;
+        int contacts = 0;
+        for (int e = 0; e < 4; ++e) {
+            int m = p + DIR4[e];
+            contacts += (m_color[m] == opponent && m_head[m] == h);
+        }
+        if (m_liberties[h] == contacts)
+            captured += m_size[h];
+    }
+    return captured == 1;
+}
+
+bool PlayoutBoard::play(int x, int y, Stone color)
+{
+    if (!GoBoard::isValidPosition(x, y))
+        return false;
+    int p = index(x, y);
+    if (!isLegalAt(p, color))
+        return false;
+
+    place(p, color);
+
+    int captured = 0;
+    int lastCaptured = -1;
+    Stone opponent = GoBoard::opponent(color);
+    for (int d = 0; d < 4; ++d) {
+        int n = p + DIR4[d];
+        if (m_color[n] == opponent && m_liberties[m_head[n]] == 0) {
+            captured += removeChain(m_head[n]);
+            lastCaptured = n;
+        }
+    }
+    m_koPoint = (captured == 1) ? lastCaptured : -1;
+    return true;
+}
+
+void PlayoutBoard::pass()
+{
+    m_koPoint = -1;
+}
+
+// 放下一子并与相邻的己方串合并（不提子）
+void PlayoutBoard::place(int p, Stone color)
+{
+    setColor(p, color);
+    m_head[p] = p;
+    m_next[p] = p;
+    m_size[p] = 1;
+    m_liberties[p] = 0;
+
+    for (int d = 0; d < 4; ++d) {
+        int n = p + DIR4[d];
+        int c = m_color[n];
+        if (c == GoBoard::EMPTY) {
+            ++m_liberties[m_head[p]];
+        } else if (c != OFF) {
+            // n 与 p 的邻接不再是气
+            --m_liberties[m_head[n]];
+            if (c == color && m_head[n] != m_head[p])
+                merge(m_head[p], m_head[n]);
+        }
+    }
+}
+
+// 把较小的串并入较大的串
+void PlayoutBoard::merge(int a, int b)
+{
+    if (m_size[a] < m_size[b])
+        std::swap(a, b);
+    int s = b;
+    do {
+        m_head[s] = a;
+        s = m_next[s];
+    } while (s != b);
+    std::swap(m_next[a], m_next[b]);
+    m_size[a] += m_size[b];
+    m_liberties[a] += m_liberties[b];
+}
+
+// 提掉一串，邻接的对方串各恢复对应的伪气
+int PlayoutBoard::removeChain(int head)
+{
+    int count = m_size[head];
+    int s = head;
+    do {
+        int next = m_next[s];
+        setColor(s, GoBoard::EMPTY);
+        for (int d = 0; d < 4; ++d) {
+            int n = s + DIR4[d];
+            int c = m_color[n];
+            // 已清空的同串棋子为空点，尚未清空的同串棋子串头仍是 head
+            if (c != GoBoard::EMPTY && c != OFF && m_head[n] != head)
+                ++m_liberties[m_head[n]];
+        }
+        s = next;
+    } while (s != head);
+    return count;
+}
+
+// 按模式权重抽样；抽到不合法的点（劫、自杀，多为对方眼位）时暂时把它的权重清零再抽，
+// 因此结果是在全部合法点上按权重的精确抽样。每次抽样先扫行和再扫行内，约 2×19 步
+bool PlayoutBoard::playRandom(Stone color, Random &random, int *x, int *y)
+{
+    int side = color - 1;
+    int excluded[N * N];
+    int excludedWeight[N * N];
+    int excludedCount = 0;
+    int chosen = -1;
+
+    while (m_totalWeight[side] > 0) {
+        int p = sample(side, random);
+        if (isLegalAt(p, color) && !(m_noKoCaptures && isKoCaptureAt(p, color))) {
+            chosen = p;
+            break;
+        }
+        excluded[excludedCount] = p;
+        excludedWeight[excludedCount++] = m_weight[side][p];
+        setWeight(side, p, 0);
+    }
+    for (int i = 0; i < excludedCount; ++i) {
+        setWeight(side, excluded[i], excludedWeight[i]);
+    }
+
+    if (chosen < 0) {
+        pass();
+        return false;
+    }
+    int px = chosen / W - 1, py = chosen % W - 1;
+    play(px, py, color);
+    if (x)
+        *x = px;
+    if (y)
+        *y = py;
+    return true;
+}
+
+int PlayoutBoard::playout(Stone toMove, Random &random, int maxPlies)
+{
+    int plies = 0;
+    int passes = 0;
+    Stone color = toMove;
+    while (passes < 2 && plies < maxPlies) {
+        m_noKoCaptures = (plies >= KO_CAPTURE_CUTOFF);
+        passes = playRandom(color, random) ? 0 : passes + 1;
+        color = GoBoard::opponent(color);
+        ++plies;
+    }
+    m_noKoCaptures = false;
+    return plies;
+}
+
+int PlayoutBoard::areaScore() const
+{
+    int score = 0;
+    for (int x = 0; x < N; ++x) {
+        for (int y = 0; y < N; ++y) {
+            int p = index(x, y);
+            int c = m_color[p];
+            if (c == GoBoard::EMPTY) {
+                bool black = false, white = false;
+                for (int d = 0; d < 4; ++d) {
+                    black |= (m_color[p + DIR4[d]] == GoBoard::BLACK);
+                    white |= (m_color[p + DIR4[d]] == GoBoard::WHITE);
+                }
+                c = (black == white) ? GoBoard::EMPTY : (black ? GoBoard::BLACK : GoBoard::WHITE);
+            }
+            score += (c == GoBoard::BLACK) - (c == GoBoard::WHITE);
+        }
+    }
+    return score;
+}
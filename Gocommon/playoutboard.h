@@ -0,0 +1,100 @@
+#ifndef PLAYOUTBOARD_H
+#define PLAYOUTBOARD_H
+
+#include "goboard.h"
+#include "patterntable.h"
+#include <cstdint>
+
+// 随机对局用的快速棋盘（规则与 GoBoard 一致，双方须轮流落子或虚着）：
+// 带一圈盘外边框的一维数组；棋串用环形链表 + 串头编号维护，合并时改小串的编号；
+// 每串维护伪气数（棋子与相邻空点的邻接对数），落子合法性 O(1) 判断；
+// 每个点维护周围 3×3 的模式编码与双方的查表权重，落子/提子时只更新8个邻点；
+// 权重按行累加，随机选点时先选行再选列
+class PlayoutBoard
+{
+public:
+    typedef GoBoard::Stone Stone;
+    static const int N = GoBoard::BOARD_SIZE;
+    static const int W = N + 2;                 // 含边框的行宽
+    static const int POINTS = W * W;
+    // 随机对局超过这么多手后不再提劫：只有简单劫规则时三劫等循环会一直下去
+    static const int KO_CAPTURE_CUTOFF = N * N;
+
+    // xorshift64* 随机数，比 std::mt19937 更轻
+    struct Random {
+        uint64_t state;
+        explicit Random(uint64_t seed = 1) : state(seed ? seed : 1) {}
+        uint32_t next()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return uint32_t((state * 2685821657736338717ULL) >> 32);
+        }
+        // [0, n)
+        uint32_t below(uint32_t n) { return uint32_t((uint64_t(next()) * n) >> 32); }
+    };
+
+    explicit PlayoutBoard(const PatternTable& table);
+
+    // clear()/load() 要重建全部编码与权重，反复开局时直接复制一个准备好的棋盘更快
+    void clear();
+    // 从 GoBoard 复制局面（提子记录只保留 toMove 需要遵守的劫）
+    void load(const GoBoard& board, Stone toMove);
+
+    Stone at(int x, int y) const { return Stone(m_color[index(x, y)]); }
+    bool isLegal(int x, int y, Stone color) const { return isLegalAt(index(x, y), color); }
+    // 落子：不合法时返回false且棋盘不变
+    bool play(int x, int y, Stone color);
+    void pass();
+
+    // 3×3 模式编码（编码方式见 PatternTable）
+    int pattern(int x, int y) const { return m_pattern[index(x, y)]; }
+    // 所在棋串的伪气数（空点返回0）
+    int pseudoLiberties(int x, int y) const;
+
+    // 校验用：双方在各点的模式权重（棋子与盘外为0）、每行之和与总和，随机选点按它们抽样；
+    // x、y 可取 -1 或 N（盘外一圈）
+    int weight(Stone color, int x, int y) const { return m_weight[color - 1][index(x, y)]; }
+    int rowWeight(Stone color, int x) const { return m_rowWeight[color - 1][x + 1]; }
+    int totalWeight(Stone color) const { return m_totalWeight[color - 1]; }
+    // 在合法点 (x, y) 落子是否为提劫（playout() 后半段不下这种棋）
+    bool isKoCapture(int x, int y, Stone color) const { return isKoCaptureAt(index(x, y), color); }
+
+    // 按模式权重随机选一个合法点落子；没有可下的点时虚着并返回false
+    bool playRandom(Stone color, Random& random, int* x = nullptr, int* y = nullptr);
+    // 从当前局面随机下到双方连续虚着或达到 maxPlies，返回手数；
+    // 超过 KO_CAPTURE_CUTOFF 手后禁止提劫，使对局自然终局
+    int playout(Stone toMove, Random& random, int maxPlies);
+    // 数子（子 + 四周只有一方棋子的空点），返回黑减白
+    int areaScore() const;
+
+private:
+    static int index(int x, int y) { return (x + 1) * W + (y + 1); }
+
+    const PatternTable* m_table;
+    uint8_t m_color[POINTS];        // 0 空 1 黑 2 白 3 盘外
+    uint16_t m_pattern[POINTS];
+    int m_head[POINTS];             // 棋子所在棋串的串头
+    int m_next[POINTS];             // 棋串内的下一颗棋子（环形）
+    int m_liberties[POINTS];        // 串头处保存伪气数
+    int m_size[POINTS];             // 串头处保存棋子数
+    int m_koPoint;                  // 上一手恰好提了一子的位置，否则 -1
+    bool m_noKoCaptures = false;    // playout() 后半段禁止提劫
+    // 双方在各空点的模式权重（非空点为0）及其行和、总和
+    int m_weight[2][POINTS];
+    int m_rowWeight[2][W];
+    int m_totalWeight[2];
+
+    bool isLegalAt(int p, Stone color) const;
+    bool isKoCaptureAt(int p, Stone color) const;
+    void place(int p, Stone color);
+    void setColor(int p, int color);
+    void updateWeight(int p);
+    void setWeight(int side, int p, int weight);
+    int sample(int side, Random& random) const;
+    void merge(int a, int b);
+    int removeChain(int head);
+};
+
+#endif // PLAYOUTBOARD_H
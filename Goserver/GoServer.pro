@@ -8,16 +8,28 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+INCLUDEPATH += ../Gocommon
+
 SOURCES += \
+    ../Gocommon/goboard.cpp \
+    ../Gocommon/goprotocol.cpp \
     gameroom.cpp \
     goserver.cpp \
+    lobbyindex.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    ratelimiter.cpp \
+    replication.cpp
 
 HEADERS += \
+    ../Gocommon/goboard.h \
+    ../Gocommon/goprotocol.h \
     gameroom.h \
     goserver.h \
-    mainwindow.h
+    lobbyindex.h \
+    mainwindow.h \
+    ratelimiter.h \
+    replication.h
 
 FORMS += \
     mainwindow.ui
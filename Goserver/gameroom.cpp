@@ -2,8 +2,7 @@
 
 GameRoom::GameRoom(int roomId, QObject *parent) : QObject(parent), m_roomId(roomId)
 {
-    // 初始化棋盘（全部为空）
-    m_board.resize(BOARD_SIZE, std::vector<Stone>(BOARD_SIZE, EMPTY));
+    // 棋盘由 GoBoard 初始化为全空
     m_currentTurn = BLACK;  // 黑方先行
     qDebug() << "Room" << m_roomId << "created (board initialized)";
 }
@@ -11,15 +10,20 @@ GameRoom::GameRoom(int roomId, QObject *parent) : QObject(parent), m_roomId(room
 // 验证落子合法性（服务器端权威校验）
 bool GameRoom::isValidMove(int x, int y, Stone player)
 {
-    // 检查坐标是否在棋盘内
-    if (x < 0 || x >= BOARD_SIZE || y < 0 || y >= BOARD_SIZE)
-        return false;
-    // 检查是否为空位
-    if (m_board[x][y] != EMPTY)
-        return false;
     // 检查是否当前回合
-    if (player != m_currentTurn)
+    if (player == EMPTY || player != m_currentTurn)
+        return false;
+    // 坐标、空位、劫争与自杀
+    return m_board.isLegalMove(x, y, player);
+}
+
+// 落子并交换回合
+bool GameRoom::applyMove(int x, int y, Stone player)
+{
+    if (player != m_currentTurn || !m_board.play(x, y, player))
         return false;
+    m_currentTurn = GoBoard::opponent(player);
+    m_history.push_back({x, y, player});
     return true;
 }
 
@@ -6,6 +6,7 @@
 #include <QList>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include "goboard.h"
 
 class GameRoom : public QObject
 {
@@ -14,31 +15,75 @@ public:
     GameRoom(int roomId, QObject *parent = nullptr);
 
     // 棋盘尺寸（19×19围棋）
-    static const int BOARD_SIZE = 19;
-    // 棋子类型
-    enum Stone { EMPTY, BLACK, WHITE };
+    static const int BOARD_SIZE = GoBoard::BOARD_SIZE;
+    // 棋子类型（与共用规则保持一致）
+    typedef GoBoard::Stone Stone;
+    static constexpr Stone EMPTY = GoBoard::EMPTY;
+    static constexpr Stone BLACK = GoBoard::BLACK;
+    static constexpr Stone WHITE = GoBoard::WHITE;
 
     int m_roomId;
 
     QList<QTcpSocket*> players;
     QMap<QTcpSocket*, QString> playerColor;
+    QMap<QTcpSocket*, int> lastSeq;     // 每个玩家最后一次被接受的落子序号
+    QList<QTcpSocket*> spectators;      // 观战者（只接收落子）
+
+    // 对局已开始（颜色与会话令牌已分配），此后只接受持令牌的玩家重连
+    bool started = false;
+    QString blackToken;
+    QString whiteToken;
+
+    // 一手棋的记录（用于热备复制与断线重连后重建棋盘）
+    struct MoveRecord {
+        int x;
+        int y;
+        Stone color;
+    };
 
     bool isFull() const { return players.size() == 2; }
     bool isEmpty() const { return players.isEmpty(); }
+    // 可以接纳新玩家：未开局且未满
+    bool isOpen() const { return !started && !isFull(); }
     QTcpSocket* getOpponent(QTcpSocket* player) const {
-        if (players[0] == player) return players.size() > 1 ? players[1] : nullptr;
+        if (players.size() < 2) return nullptr;
+        if (players[0] == player) return players[1];
         if (players[1] == player) return players[0];
         return nullptr;
     }
 
+    Stone colorOf(QTcpSocket* player) const {
+        QString color = playerColor.value(player);
+        if (color == "black") return BLACK;
+        if (color == "white") return WHITE;
+        return EMPTY;
+    }
+
+    // 验证落子合法性
+    bool isValidMove(int x, int y, Stone player);
+    // 落子（调用前须先 isValidMove），提子结果见 lastCapture
+    bool applyMove(int x, int y, Stone player);
+    const GoBoard::CaptureInfo& lastCapture(Stone player) const { return m_board.lastCapture(player); }
+    // 已落子的手数（作为权威的着手编号）
+    int moveCount() const { return static_cast<int>(m_history.size()); }
+    const std::vector<MoveRecord>& history() const { return m_history; }
+
+    // 按令牌查颜色，令牌无效时返回 EMPTY
+    Stone colorForToken(const QString& token) const {
+        if (token.isEmpty()) return EMPTY;
+        if (token == blackToken) return BLACK;
+        if (token == whiteToken) return WHITE;
+        return EMPTY;
+    }
+
 private:
     // 棋盘
-    std::vector<std::vector<Stone>> m_board;
+    GoBoard m_board;
     // 当前回合（黑方先行）
     Stone m_currentTurn;
+    // 已落的棋（按顺序）
+    std::vector<MoveRecord> m_history;
 
-    // 验证落子合法性
-    bool isValidMove(int x, int y, Stone player);
     // 新判断赢棋
     bool checkWin(int x, int y, Stone player);
 };
@@ -1,14 +1,31 @@
 #include "goserver.h"
 #include "gameroom.h"
+#include "goprotocol.h"
 #include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QUuid>
 
-GoServer::GoServer(QObject *parent) : QTcpServer(parent)
+namespace {
+// 允许原样转发给对手的消息类型（申请数子及其答复）；
+// ack、resumed、颜色分配等只能由服务器发出，客户端发来的一律丢弃
+const QSet<QString> RELAY_TYPES = { "over", "over_reply" };
+}
+
+GoServer::GoServer(quint16 port, QObject *parent) : QTcpServer(parent), m_port(port)
 {
-    if (!listen(QHostAddress::Any, 1234)) {
-        qDebug() << "Server could not start!";
-    } else {
-        qDebug() << "Server started on port 1234";
-    }
+    m_takeOverTimer.setInterval(TAKEOVER_RETRY_MS);
+    connect(&m_takeOverTimer, &QTimer::timeout, this, &GoServer::takeOver);
+    m_resumeDeadlineTimer.setSingleShot(true);
+    m_resumeDeadlineTimer.setInterval(RESUME_DEADLINE_MS);
+    connect(&m_resumeDeadlineTimer, &QTimer::timeout, this, &GoServer::dropUnclaimedRooms);
+
+    m_clock.start();
+    connect(&m_pruneTimer, &QTimer::timeout, this, &GoServer::pruneConnectionBuckets);
+    m_pruneTimer.start(PRUNE_INTERVAL_MS);
+
+    m_lobbyFlushTimer.setSingleShot(true);
+    connect(&m_lobbyFlushTimer, &QTimer::timeout, this, &GoServer::flushLobbyDeltas);
 }
 
 GoServer::~GoServer()
@@ -16,57 +33,418 @@ GoServer::~GoServer()
     close();
 }
 
-// 查找未满房间，若无则创建新房间
-int GoServer::findOrCreateRoom()
+bool GoServer::startPrimary(const QString &replicaName)
 {
-    // 优先加入已有未满房间
+    if (!listen(QHostAddress::Any, m_port)) {
+        qDebug() << "Server could not start!";
+        return false;
+    }
+    qDebug() << "Server started on port" << m_port;
+
+    m_replicaName = replicaName;
+    if (!replicaName.isEmpty()) {
+        m_replication = new ReplicationSender(replicaName, this);
+        connect(m_replication, &ReplicationSender::standbyConnected, this, &GoServer::sendSnapshot);
+        m_replication->start();
+    }
+    return true;
+}
+
+bool GoServer::startStandby(const QString &replicaName)
+{
+    m_replicaName = replicaName;
+    m_standby = new ReplicationReceiver(replicaName, this);
+    connect(m_standby, &ReplicationReceiver::eventReceived, this, &GoServer::applyReplicationEvent);
+    connect(m_standby, &ReplicationReceiver::primaryLost, this, &GoServer::takeOver);
+    return m_standby->start();
+}
+
+// 主服务器断开：停止接收事件流，反复尝试监听端口直到成功，
+// 之后作为新的主服务器等待客户端重连，并为下一个热备提供事件流
+void GoServer::takeOver()
+{
+    if (m_standby) {
+        m_standby->stop();
+        m_standby->deleteLater();
+        m_standby = nullptr;
+        qDebug() << "Taking over with" << rooms.size() << "rooms";
+    }
+    if (!listen(QHostAddress::Any, m_port)) {
+        if (!m_takeOverTimer.isActive()) {
+            m_takeOverTimer.start();
+        }
+        return;
+    }
+    m_takeOverTimer.stop();
+    qDebug() << "Standby took over port" << m_port;
+    // 复制来的房间都没有玩家连接，期限内没人持令牌回来的就是废弃房间
+    m_resumeDeadlineTimer.start();
+
+    m_replication = new ReplicationSender(m_replicaName, this);
+    connect(m_replication, &ReplicationSender::standbyConnected, this, &GoServer::sendSnapshot);
+    m_replication->start();
+}
+
+// 接管期限到：仍然没有玩家的房间（对局双方都没回来，或开局前就只剩空房）全部删除
+void GoServer::dropUnclaimedRooms()
+{
+    QList<int> unclaimed;
+    for (auto it = rooms.constBegin(); it != rooms.constEnd(); ++it) {
+        if (it.value()->isEmpty()) {
+            unclaimed.append(it.key());
+        }
+    }
+    for (int roomId : unclaimed) {
+        deleteRoom(roomId);
+    }
+    qDebug() << "Resume deadline passed," << unclaimed.size() << "unclaimed rooms deleted";
+}
+
+void GoServer::replicate(const QJsonObject &event)
+{
+    if (m_replication) {
+        m_replication->append(event);
+    }
+}
+
+void GoServer::appendRoomEvents(const QSharedPointer<GameRoom> &room)
+{
+    int roomId = room->m_roomId;
+    m_replication->append(QJsonObject{{"ev", "room_created"}, {"room", roomId}});
+    if (room->started) {
+        m_replication->append(QJsonObject{
+            {"ev", "room_started"}, {"room", roomId},
+            {"black", room->blackToken}, {"white", room->whiteToken}
+        });
+    }
+    for (const GameRoom::MoveRecord& move : room->history()) {
+        m_replication->append(QJsonObject{
+            {"ev", "move"}, {"room", roomId}, {"x", move.x}, {"y", move.y}, {"color", int(move.color)}
+        });
+    }
+}
+
+void GoServer::sendSnapshot()
+{
+    m_replication->append(QJsonObject{{"ev", "snapshot"}, {"nextRoomId", nextRoomId}});
     for (auto it = rooms.begin(); it != rooms.end(); ++it) {
-        if (!it.value()->isFull()) {
-            return it.key();
+        appendRoomEvents(it.value());
+    }
+    qDebug() << "Snapshot of" << rooms.size() << "rooms sent to standby";
+}
+
+// 热备端应用事件：与主服务器上的房间状态保持一致（没有玩家连接）
+void GoServer::applyReplicationEvent(const QJsonObject &event)
+{
+    QString type = event["ev"].toString();
+    int roomId = event["room"].toInt();
+
+    if (type == "snapshot") {
+        rooms.clear();
+        lobby = LobbyIndex();
+        nextRoomId = event["nextRoomId"].toInt(1);
+    } else if (type == "room_created") {
+        rooms[roomId] = QSharedPointer<GameRoom>(new GameRoom(roomId));
+        nextRoomId = qMax(nextRoomId, roomId + 1);
+        updateLobby(roomId);
+    } else if (type == "room_started" && rooms.contains(roomId)) {
+        QSharedPointer<GameRoom> room = rooms[roomId];
+        room->started = true;
+        room->blackToken = event["black"].toString();
+        room->whiteToken = event["white"].toString();
+        updateLobby(roomId);
+    } else if (type == "move" && rooms.contains(roomId)) {
+        GameRoom::Stone color = static_cast<GameRoom::Stone>(event["color"].toInt());
+        if (!rooms[roomId]->applyMove(event["x"].toInt(), event["y"].toInt(), color)) {
+            qDebug() << "Replicated move rejected in room" << roomId;
         }
+    } else if (type == "room_deleted") {
+        rooms.remove(roomId);
+        updateLobby(roomId);
+    }
+}
+
+// 查找未满房间，若无则创建新房间
+int GoServer::findOrCreateRoom()
+{
+    // 优先加入已有未满房间（由大厅索引直接给出）
+    int roomId = lobby.firstOpen();
+    if (roomId != 0) {
+        return roomId;
     }
     // 无未满房间，创建新房间
+    return createRoom();
+}
+
+int GoServer::createRoom()
+{
     int newRoomId = nextRoomId++;
     rooms[newRoomId] =  QSharedPointer<GameRoom>(new GameRoom(newRoomId));
+    replicate(QJsonObject{{"ev", "room_created"}, {"room", newRoomId}});
+    updateLobby(newRoomId);
     qDebug() << "Created new room (ID:" << newRoomId << ")";
     return newRoomId;
 }
 
+void GoServer::updateLobby(int roomId)
+{
+    QSharedPointer<GameRoom> room = rooms.value(roomId);
+    if (room) {
+        LobbyIndex::Entry entry;
+        entry.roomId = roomId;
+        entry.state = room->started ? LobbyIndex::InProgress : LobbyIndex::Open;
+        entry.players = room->players.size();
+        entry.spectators = room->spectators.size();
+        lobby.upsert(entry);
+    } else {
+        lobby.remove(roomId);
+    }
+
+    // 没有订阅者时不攒变化
+    if (!lobbySubscribers.isEmpty()) {
+        lobbyDirty.insert(roomId);
+        if (!m_lobbyFlushTimer.isActive()) {
+            m_lobbyFlushTimer.start(LOBBY_FLUSH_MS);
+        }
+    }
+}
+
+void GoServer::flushLobbyDeltas()
+{
+    if (lobbyDirty.isEmpty())
+        return;
+
+    QJsonArray changes;
+    for (int roomId : lobbyDirty) {
+        if (lobby.contains(roomId)) {
+            QJsonObject change = lobbyEntryToJson(lobby.entry(roomId));
+            change["op"] = "upsert";
+            changes.append(change);
+        } else {
+            changes.append(QJsonObject{{"op", "remove"}, {"room", roomId}});
+        }
+    }
+    lobbyDirty.clear();
+
+    QJsonObject delta{{"type", "lobby_delta"}, {"changes", changes}};
+    for (auto it = lobbySubscribers.begin(); it != lobbySubscribers.end(); ) {
+        QTcpSocket* subscriber = *it;
+        if (subscriber->bytesToWrite() < MAX_PENDING_WRITE_BYTES) {
+            sendMessage(subscriber, delta);
+            ++it;
+            continue;
+        }
+        // 跟不上推送的订阅者直接退订：悄悄丢掉变化会让它的列表永久出错，
+        // 收到通知后可以重新订阅并用 lobby_list 拉取完整列表
+        it = lobbySubscribers.erase(it);
+        sendMessage(subscriber, QJsonObject{{"type", "lobby_unsubscribed"}, {"reason", "lagging"}});
+        qDebug() << "Lobby subscriber fell behind, unsubscribed";
+    }
+}
+
+QJsonObject GoServer::lobbyEntryToJson(const LobbyIndex::Entry &entry)
+{
+    return QJsonObject{
+        {"room", entry.roomId},
+        {"state", entry.state == LobbyIndex::Open ? "open" : "in_progress"},
+        {"players", entry.players},
+        {"spectators", entry.spectators},
+        {"spectatable", LobbyIndex::inCategory(entry, LobbyIndex::SpectatableRooms)}
+    };
+}
+
+bool GoServer::handleLobbyQuery(QTcpSocket *socket, const QJsonObject &obj)
+{
+    QString type = obj["type"].toString();
+    if (type == "lobby_list") {
+        // 分类 + 游标（上一页最后一个房间号）+ 页大小
+        QString categoryName = obj["category"].toString("open");
+        LobbyIndex::Category category = LobbyIndex::OpenRooms;
+        if (categoryName == "in_progress") {
+            category = LobbyIndex::InProgressRooms;
+        } else if (categoryName == "spectatable") {
+            category = LobbyIndex::SpectatableRooms;
+        } else {
+            categoryName = "open";
+        }
+        int limit = qBound(1, obj["limit"].toInt(20), LOBBY_PAGE_MAX);
+        int next = 0;
+        QJsonArray list;
+        for (const LobbyIndex::Entry& entry : lobby.page(category, obj["cursor"].toInt(0), limit, &next)) {
+            list.append(lobbyEntryToJson(entry));
+        }
+        sendMessage(socket, QJsonObject{
+            {"type", "lobby_page"}, {"category", categoryName}, {"rooms", list},
+            {"next", next}, {"total", lobby.count(category)}
+        });
+        return true;
+    }
+    if (type == "lobby_subscribe") {
+        lobbySubscribers.insert(socket);
+        sendMessage(socket, QJsonObject{
+            {"type", "lobby_subscribed"},
+            {"open", lobby.count(LobbyIndex::OpenRooms)},
+            {"in_progress", lobby.count(LobbyIndex::InProgressRooms)},
+            {"spectatable", lobby.count(LobbyIndex::SpectatableRooms)}
+        });
+        return true;
+    }
+    if (type == "lobby_unsubscribe") {
+        lobbySubscribers.remove(socket);
+        return true;
+    }
+    return false;
+}
+
+void GoServer::spectateRoom(QTcpSocket *socket, const QJsonObject &obj)
+{
+    int roomId = obj["room"].toInt();
+    if (!lobby.contains(roomId) || !LobbyIndex::inCategory(lobby.entry(roomId), LobbyIndex::SpectatableRooms)
+        || socket->property("spectateRoom").toInt() != 0) {
+        sendMessage(socket, QJsonObject{{"type", "spectate_failed"}, {"room", roomId}});
+        return;
+    }
+    QSharedPointer<GameRoom> room = rooms[roomId];
+    room->spectators.append(socket);
+    socket->setProperty("spectateRoom", roomId);
+    updateLobby(roomId);
+
+    QJsonArray moves;
+    for (const GameRoom::MoveRecord& move : room->history()) {
+        moves.append(QJsonArray{move.x, move.y, int(move.color)});
+    }
+    sendMessage(socket, QJsonObject{{"type", "spectating"}, {"room", roomId}, {"moves", moves}});
+}
+
 // 获取客户端所在房间ID（通过socket属性存储）
 int GoServer::getRoomId(QTcpSocket *socket)
 {
     return socket->property("roomId").toInt();
 }
 
-// 处理新客户端连接
+// 处理新客户端连接（等待客户端发送 join 或 resume 后再进入房间）
 void GoServer::incomingConnection(qintptr socketDescriptor)
 {
     QTcpSocket* clientSocket = new QTcpSocket(this);
     clientSocket->setSocketDescriptor(socketDescriptor);
-    qDebug() << "New client connected (socket:" << clientSocket->socketDescriptor() << ")";
 
-    // 分配房间
-    int roomId = findOrCreateRoom();
-    QSharedPointer<GameRoom> room = rooms[roomId];
+    // 同一来源地址建连过快：直接关闭，不分配任何状态
+    qint64 now = m_clock.elapsed();
+    QString address = clientSocket->peerAddress().toString();
+    auto bucket = connectionBuckets.find(address);
+    if (bucket == connectionBuckets.end()) {
+        bucket = connectionBuckets.insert(address, TokenBucket(m_limits.connectionsPerSecond, m_limits.connectionBurst, now));
+    }
+    if (!bucket->consume(1, now)) {
+        qDebug() << "Connection rate limit exceeded for" << address;
+        clientSocket->abort();
+        clientSocket->deleteLater();
+        return;
+    }
+    qDebug() << "New client connected (socket:" << clientSocket->socketDescriptor() << ")";
 
-    // 将客户端加入房间
-    room->players.append(clientSocket);
-    // 记录客户端所在房间（通过socket属性）
-    clientSocket->setProperty("roomId", roomId);
+    ClientLimits limits;
+    limits.messages = TokenBucket(m_limits.messagesPerSecond, m_limits.messageBurst, now);
+    limits.bytes = TokenBucket(m_limits.bytesPerSecond, m_limits.byteBurst, now);
+    limits.violations = DecayingCounter(m_limits.violationDecayPerSecond, now);
+    clientLimits.insert(clientSocket, limits);
+    // 限制Qt内部读缓冲，读不完的数据留在内核中，由TCP反压对端
+    if (m_limits.bytesPerSecond > 0) {
+        clientSocket->setReadBufferSize(qMax<qint64>(m_limits.maxFrameBytes * 4, qint64(m_limits.byteBurst)));
+    }
 
     // 连接信号槽（处理消息和断开）
     connect(clientSocket, &QTcpSocket::readyRead, this, &GoServer::readClient);
     connect(clientSocket, &QTcpSocket::disconnected, this, &GoServer::clientDisconnected);
+}
+
+void GoServer::joinRoom(QTcpSocket *socket, int roomId)
+{
+    QSharedPointer<GameRoom> room = rooms[roomId];
 
-    // 若房间已满（2人），分配颜色并通知开始
+    // 将客户端加入房间
+    room->players.append(socket);
+    // 记录客户端所在房间（通过socket属性）
+    socket->setProperty("roomId", roomId);
+
+    // 若房间已满（2人），分配颜色与会话令牌并通知开始
     if (room->isFull()) {
+        room->started = true;
+        room->blackToken = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        room->whiteToken = QUuid::createUuid().toString(QUuid::WithoutBraces);
         // 分配颜色
         room->playerColor[room->players[0]] = "black";
         room->playerColor[room->players[1]] = "white";
+        updateLobby(roomId);
+        replicate(QJsonObject{
+            {"ev", "room_started"}, {"room", roomId},
+            {"black", room->blackToken}, {"white", room->whiteToken}
+        });
         // 通知两个客户端颜色信息
-        sendMessage(room->players[0], QJsonObject{{"color", "black"}});
-        sendMessage(room->players[1], QJsonObject{{"color", "white"}});
+        sendMessage(room->players[0], QJsonObject{{"color", "black"}, {"room", roomId}, {"token", room->blackToken}});
+        sendMessage(room->players[1], QJsonObject{{"color", "white"}, {"room", roomId}, {"token", room->whiteToken}});
         qDebug() << "Room" << roomId << "is full (2 players), game started";
+    } else {
+        updateLobby(roomId);
+    }
+}
+
+void GoServer::resumeSession(QTcpSocket *socket, const QJsonObject &obj)
+{
+    int roomId = obj["room"].toInt();
+    QSharedPointer<GameRoom> room = rooms.value(roomId);
+    GameRoom::Stone color = room ? room->colorForToken(obj["token"].toString()) : GameRoom::EMPTY;
+    // 令牌无效，或该颜色已有人在线
+    if (color == GameRoom::EMPTY || room->playerColor.key(color == GameRoom::BLACK ? "black" : "white")) {
+        sendMessage(socket, QJsonObject{{"type", "resume_failed"}, {"room", roomId}});
+        qDebug() << "Resume rejected for room" << roomId;
+        return;
+    }
+
+    QString colorName = (color == GameRoom::BLACK) ? "black" : "white";
+    room->players.append(socket);
+    room->playerColor[socket] = colorName;
+    socket->setProperty("roomId", roomId);
+    updateLobby(roomId);
+
+    // 发送完整棋谱，客户端据此重建棋盘
+    QJsonArray moves;
+    for (const GameRoom::MoveRecord& move : room->history()) {
+        moves.append(QJsonArray{move.x, move.y, int(move.color)});
+    }
+    sendMessage(socket, QJsonObject{
+        {"type", "resumed"}, {"room", roomId}, {"color", colorName}, {"moves", moves}
+    });
+    QTcpSocket* opponent = room->getOpponent(socket);
+    if (opponent) {
+        sendMessage(opponent, QJsonObject{{"info", "opponent_resumed"}});
+    }
+    qDebug() << "Client resumed" << colorName << "in room" << roomId;
+}
+
+void GoServer::handleLobbyMessage(QTcpSocket *socket, const QJsonObject &obj)
+{
+    QString type = obj["type"].toString();
+    if (type == "join") {
+        // 指定房间号则加入该房间（须仍在等待中），否则自动匹配
+        if (obj.contains("room")) {
+            int roomId = obj["room"].toInt();
+            if (!lobby.contains(roomId) || lobby.entry(roomId).state != LobbyIndex::Open) {
+                sendMessage(socket, QJsonObject{{"type", "join_failed"}, {"room", roomId}});
+                return;
+            }
+            joinRoom(socket, roomId);
+        } else {
+            joinRoom(socket, findOrCreateRoom());
+        }
+    } else if (type == "create") {
+        joinRoom(socket, createRoom());
+    } else if (type == "spectate") {
+        spectateRoom(socket, obj);
+    } else if (type == "resume") {
+        resumeSession(socket, obj);
+    } else {
+        qDebug() << "Client not in any room";
     }
 }
 
@@ -75,28 +453,184 @@ void GoServer::readClient()
 {
     QTcpSocket* senderSocket = qobject_cast<QTcpSocket*>(sender());
     if (!senderSocket) return;
+    // 正在等令牌补足，到时由定时器继续读取
+    auto limits = clientLimits.constFind(senderSocket);
+    if (limits != clientLimits.constEnd() && limits->resumeScheduled) return;
+    processClientData(senderSocket);
+}
 
-    // 获取发送者所在房间
-    int roomId = getRoomId(senderSocket);
-    if (!rooms.contains(roomId)) {
-        qDebug() << "Client not in any room";
+void GoServer::processClientData(QTcpSocket *socket)
+{
+    if (socket->state() != QTcpSocket::ConnectedState || !clientLimits.contains(socket))
         return;
+    ClientLimits& limits = clientLimits[socket];
+    qint64 now = m_clock.elapsed();
+
+    // 字节配额：只读取令牌允许的部分，剩余数据等令牌补足后再读
+    qint64 pending = socket->bytesAvailable();
+    qint64 allowed = qint64(qMin<double>(double(pending), limits.bytes.available(now)));
+    limits.bytes.consume(double(allowed), now);
+    if (allowed < pending) {
+        qint64 delay = qMax<qint64>(1, limits.bytes.msUntil(qMin<double>(double(pending - allowed), m_limits.byteBurst), now));
+        limits.resumeScheduled = true;
+        QTimer::singleShot(int(delay), socket, [this, socket]() {
+            auto it = clientLimits.find(socket);
+            if (it == clientLimits.end()) return;
+            it->resumeScheduled = false;
+            processClientData(socket);
+        });
     }
-    QSharedPointer<GameRoom> room = rooms[roomId];
 
-    // 读取消息
-    QByteArray data = senderSocket->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        qDebug() << "Invalid message from client (socket:" << senderSocket->socketDescriptor() << ")";
+    // 按行切分（只找换行符，不解析JSON），超长或超出消息配额的行直接丢弃
+    QByteArray& buffer = readBuffers[socket];
+    buffer.append(socket->read(allowed));
+    QByteArray accepted;
+    QList<QJsonObject> rejectedMoves;
+    double violations = limits.violations.value(now);
+    int start = 0;
+    int end;
+    while ((end = buffer.indexOf('\n', start)) >= 0) {
+        int length = end - start;
+        if (m_limits.maxFrameBytes > 0 && length > m_limits.maxFrameBytes) {
+            violations = limits.violations.add(1, now);
+        } else if (!limits.messages.consume(1, now)) {
+            violations = limits.violations.add(1, now);
+            // 超出配额的落子不能悄悄丢掉，否则客户端一直等确认；先粗筛再解析
+            QByteArray line = QByteArray::fromRawData(buffer.constData() + start, length);
+            if (line.contains("\"move\"")) {
+                QJsonObject obj = QJsonDocument::fromJson(line).object();
+                if (obj["type"].toString() == "move") {
+                    rejectedMoves.append(obj);
+                }
+            }
+        } else {
+            accepted.append(buffer.constData() + start, length + 1);
+        }
+        start = end + 1;
+    }
+    buffer.remove(0, start);
+
+    // 未结束的一行已超过最大长度，或短时间内丢弃过多：断开（abort 会同步清理该连接的状态）
+    if ((m_limits.maxFrameBytes > 0 && buffer.size() > m_limits.maxFrameBytes)
+        || (m_limits.maxViolations > 0 && violations > m_limits.maxViolations)) {
+        qDebug() << "Dropping abusive client (socket:" << socket->socketDescriptor() << ")";
+        socket->abort();
+        return;
+    }
+
+    int invalid = 0;
+    const QList<QJsonObject> messages = GoProtocol::takeMessages(accepted, &invalid);
+    if (invalid > 0) {
+        qDebug() << "Invalid message from client (socket:" << socket->socketDescriptor() << ")";
+    }
+
+    for (const QJsonObject& obj : messages) {
+        if (handleLobbyQuery(socket, obj)) {
+            continue;
+        }
+        // 获取发送者所在房间（join/resume 之后才有）
+        int roomId = getRoomId(socket);
+        if (!rooms.contains(roomId)) {
+            handleLobbyMessage(socket, obj);
+            continue;
+        }
+        handleMessage(socket, rooms[roomId], obj);
+    }
+
+    // 同一批里配额一旦用完后面的行都会被丢弃，所以拒绝确认放在最后发，顺序与客户端发出的一致
+    for (const QJsonObject& obj : rejectedMoves) {
+        if (socket->bytesToWrite() >= MAX_PENDING_WRITE_BYTES)
+            break;
+        sendMessage(socket, QJsonObject{
+            {"type", "ack"}, {"seq", obj["seq"].toInt()},
+            {"x", obj["x"].toInt(-1)}, {"y", obj["y"].toInt(-1)},
+            {"accepted", false}, {"reason", "rate_limited"}
+        });
+    }
+}
+
+void GoServer::pruneConnectionBuckets()
+{
+    qint64 now = m_clock.elapsed();
+    for (auto it = connectionBuckets.begin(); it != connectionBuckets.end(); ) {
+        if (it->isFull(now)) {
+            it = connectionBuckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GoServer::handleMessage(QTcpSocket *socket, const QSharedPointer<GameRoom> &room, const QJsonObject &obj)
+{
+    if (obj["type"].toString() == "move") {
+        handleMove(socket, room, obj);
+        return;
+    }
+
+    if (!RELAY_TYPES.contains(obj["type"].toString())) {
+        qDebug() << "Dropped non-relayable message" << obj["type"].toString() << "in room" << room->m_roomId;
         return;
     }
 
-    // 转发给同房间的对手
-    QTcpSocket* opponent = room->getOpponent(senderSocket);
+    // 转发给同房间的对手（对方发送缓冲积压过多时丢弃）
+    QTcpSocket* opponent = room->getOpponent(socket);
+    if (opponent && opponent->state() == QTcpSocket::ConnectedState
+        && opponent->bytesToWrite() < MAX_PENDING_WRITE_BYTES) {
+        sendMessage(opponent, obj);
+        qDebug() << "Message forwarded in room" << room->m_roomId;
+    }
+}
+
+void GoServer::handleMove(QTcpSocket *socket, const QSharedPointer<GameRoom> &room, const QJsonObject &obj)
+{
+    int seq = obj["seq"].toInt();
+    int x = obj["x"].toInt(-1);
+    int y = obj["y"].toInt(-1);
+    GameRoom::Stone player = room->colorOf(socket);
+
+    QJsonObject ack{{"type", "ack"}, {"seq", seq}, {"x", x}, {"y", y}};
+
+    // 按序号、回合和规则校验，不通过则让客户端回滚
+    QString reason;
+    if (!room->started || !room->isFull()) {
+        reason = "waiting_for_opponent";
+    } else if (seq <= room->lastSeq.value(socket, 0)) {
+        reason = "stale_sequence";
+    } else if (!room->isValidMove(x, y, player) || !room->applyMove(x, y, player)) {
+        reason = "illegal_move";
+    }
+    if (!reason.isEmpty()) {
+        ack["accepted"] = false;
+        ack["reason"] = reason;
+        sendMessage(socket, ack);
+        qDebug() << "Move rejected in room" << room->m_roomId << "(" << reason << ")";
+        return;
+    }
+    room->lastSeq[socket] = seq;
+    replicate(QJsonObject{{"ev", "move"}, {"room", room->m_roomId}, {"x", x}, {"y", y}, {"color", int(player)}});
+
+    QJsonArray captures = GoProtocol::pointsToJson(room->lastCapture(player).positions);
+    ack["accepted"] = true;
+    ack["moveNo"] = room->moveCount();
+    ack["captures"] = captures;
+    sendMessage(socket, ack);
+
+    // 通知对手与观战者（同样带上权威提子结果）
+    QJsonObject move{
+        {"type", "move"}, {"x", x}, {"y", y},
+        {"moveNo", room->moveCount()}, {"captures", captures}
+    };
+    QTcpSocket* opponent = room->getOpponent(socket);
     if (opponent && opponent->state() == QTcpSocket::ConnectedState) {
-        opponent->write(data);  // 直接转发原始数据（确保格式一致）
-        qDebug() << "Message forwarded in room" << roomId;
+        sendMessage(opponent, move);
+    }
+    // 观战者没有自己的颜色，需要知道是哪一方落的子
+    move["color"] = int(player);
+    for (QTcpSocket* spectator : room->spectators) {
+        if (spectator->bytesToWrite() < MAX_PENDING_WRITE_BYTES) {
+            sendMessage(spectator, move);
+        }
     }
 }
 
@@ -106,33 +640,56 @@ void GoServer::clientDisconnected()
     QTcpSocket* clientSocket = qobject_cast<QTcpSocket*>(sender());
     if (!clientSocket) return;
 
+    readBuffers.remove(clientSocket);
+    clientLimits.remove(clientSocket);
+    lobbySubscribers.remove(clientSocket);
+    clientSocket->deleteLater();
+
+    // 观战者离开
+    int spectateRoomId = clientSocket->property("spectateRoom").toInt();
+    if (rooms.contains(spectateRoomId)) {
+        rooms[spectateRoomId]->spectators.removeOne(clientSocket);
+        updateLobby(spectateRoomId);
+    }
+
     int roomId = getRoomId(clientSocket);
     if (!rooms.contains(roomId)) return;
 
     QSharedPointer<GameRoom> room = rooms[roomId];
     qDebug() << "Client disconnected from room" << roomId;
 
-    // 从房间移除客户端
+    // 从房间移除客户端（已开局的座位保留，持令牌可重连）
     room->players.removeOne(clientSocket);
     room->playerColor.remove(clientSocket);
+    room->lastSeq.remove(clientSocket);
 
     // 若房间为空，删除房间
     if (room->isEmpty()) {
-        rooms.remove(roomId);
+        deleteRoom(roomId);
         qDebug() << "Room" << roomId << "is empty, deleted";
     } else {
+        updateLobby(roomId);
         // 若房间还剩1人，通知其对手已离开
         if (!room->players.isEmpty()) {
             sendMessage(room->players[0], QJsonObject{{"info", "opponent_disconnected"}});
         }
     }
+}
 
-    clientSocket->deleteLater();
+void GoServer::deleteRoom(int roomId)
+{
+    QSharedPointer<GameRoom> room = rooms.take(roomId);
+    if (!room) return;
+    for (QTcpSocket* spectator : room->spectators) {
+        spectator->setProperty("spectateRoom", 0);
+        sendMessage(spectator, QJsonObject{{"info", "room_closed"}, {"room", roomId}});
+    }
+    updateLobby(roomId);
+    replicate(QJsonObject{{"ev", "room_deleted"}, {"room", roomId}});
 }
 
 // 发送消息给客户端
 void GoServer::sendMessage(QTcpSocket *socket, const QJsonObject &obj)
 {
-    QJsonDocument doc(obj);
-    socket->write(doc.toJson());
+    socket->write(GoProtocol::encode(obj));
 }
@@ -2,31 +2,116 @@
 #define GOSERVER_H
 
 #include "gameroom.h"
+#include "replication.h"
+#include "ratelimiter.h"
+#include "lobbyindex.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
 
 class GoServer : public QTcpServer
 {
     Q_OBJECT
 public:
-    explicit GoServer(QObject *parent = nullptr);
+    explicit GoServer(quint16 port = 1234, QObject *parent = nullptr);
     ~GoServer();
 
+    // 以主服务器身份启动：监听端口，并把事件流复制给同机热备（replicaName 为空则不复制）
+    bool startPrimary(const QString& replicaName);
+    // 以热备身份启动：只接收事件流，主服务器断开后接管端口
+    bool startStandby(const QString& replicaName);
+    // 设置限流参数（对之后建立的连接生效）
+    void setRateLimits(const RateLimitConfig& config) { m_limits = config; }
+
 protected:
     void incomingConnection(qintptr socketDescriptor) override;
 
 private slots:
     void readClient();       // 处理客户端消息
     void clientDisconnected();  // 处理客户端断开
+    void applyReplicationEvent(const QJsonObject& event);  // 热备：应用一条复制事件
+    void sendSnapshot();        // 主服务器：热备连上后发送全部房间状态
+    void takeOver();            // 热备：主服务器断开，接管端口
+    void pruneConnectionBuckets();  // 回收长时间未使用的来源地址令牌桶
+    void flushLobbyDeltas();    // 把攒下的大厅变化推送给订阅者
+    void dropUnclaimedRooms();  // 接管后到期仍无人重连的房间一律删除
 
 private:
     QMap<int, QSharedPointer<GameRoom>> rooms;  // 管理所有房间（房间ID -> 房间对象）
     int nextRoomId = 1;         // 下一个可用房间ID
+    QMap<QTcpSocket*, QByteArray> readBuffers;  // 每个客户端尚未凑成整行的数据
+
+    quint16 m_port;
+    QString m_replicaName;
+    ReplicationSender *m_replication = nullptr;   // 主服务器：事件流发送端
+    ReplicationReceiver *m_standby = nullptr;     // 热备：事件流接收端
+    QTimer m_takeOverTimer;                       // 热备接管时重试监听端口
+    // 接管端口的重试间隔（毫秒）
+    static const int TAKEOVER_RETRY_MS = 200;
+    QTimer m_resumeDeadlineTimer;                 // 接管后等待玩家重连的期限
+    static const int RESUME_DEADLINE_MS = 60 * 1000;
+
+    // 限流：每个连接的消息与字节令牌桶，每个来源地址的建连令牌桶
+    struct ClientLimits {
+        TokenBucket messages;
+        TokenBucket bytes;
+        DecayingCounter violations; // 被丢弃的消息数（随时间衰减，偶尔超限不会累积到断开）
+        bool resumeScheduled = false;  // 已安排在令牌补足后继续读取
+    };
+    RateLimitConfig m_limits;
+    QElapsedTimer m_clock;
+    QMap<QTcpSocket*, ClientLimits> clientLimits;
+    QHash<QString, TokenBucket> connectionBuckets;
+    QTimer m_pruneTimer;
+    // 对手的发送缓冲超过该值时不再向其转发，防止被刷屏的连接无限堆积
+    static const qint64 MAX_PENDING_WRITE_BYTES = 256 * 1024;
+    static const int PRUNE_INTERVAL_MS = 60 * 1000;
+
+    // 按字节配额读取数据，按帧长与消息配额过滤后再解析和处理
+    void processClientData(QTcpSocket* socket);
+
+    // 复制一条事件（未启用复制时忽略）
+    void replicate(const QJsonObject& event);
+    // 同一房间的全部事件（用于快照）
+    void appendRoomEvents(const QSharedPointer<GameRoom>& room);
+
+    // 大厅：房间索引、订阅者与待推送的变化
+    LobbyIndex lobby;
+    QSet<QTcpSocket*> lobbySubscribers;
+    QSet<int> lobbyDirty;
+    QTimer m_lobbyFlushTimer;
+    // 变化推送的攒批间隔（毫秒）与单页最大房间数
+    static const int LOBBY_FLUSH_MS = 100;
+    static constexpr int LOBBY_PAGE_MAX = 100;
+
+    // 按房间当前状态更新大厅索引，并记下待推送的变化（房间已删除则移出索引）
+    void updateLobby(int roomId);
+    // 处理大厅查询与订阅（任何连接都可以发），已处理返回 true
+    bool handleLobbyQuery(QTcpSocket* socket, const QJsonObject& obj);
+    // 观战一个进行中的房间
+    void spectateRoom(QTcpSocket* socket, const QJsonObject& obj);
+    static QJsonObject lobbyEntryToJson(const LobbyIndex::Entry& entry);
 
     // 查找或创建可用房间
     int findOrCreateRoom();
+    // 新建房间
+    int createRoom();
+    // 删除房间：通知观战者、更新大厅并复制删除事件
+    void deleteRoom(int roomId);
     // 发送消息给客户端
     void sendMessage(QTcpSocket* socket, const QJsonObject& obj);
     // 获取客户端所在房间ID
     int getRoomId(QTcpSocket* socket);
+    // 处理尚未进入房间的客户端的消息（匹配或断线重连）
+    void handleLobbyMessage(QTcpSocket* socket, const QJsonObject& obj);
+    // 加入房间，满员时开局
+    void joinRoom(QTcpSocket* socket, int roomId);
+    // 持令牌回到已开始的对局，并发送完整棋谱
+    void resumeSession(QTcpSocket* socket, const QJsonObject& obj);
+    // 处理一条完整的客户端消息
+    void handleMessage(QTcpSocket* socket, const QSharedPointer<GameRoom>& room, const QJsonObject& obj);
+    // 校验并落子，回复确认（含权威提子结果）并通知对手
+    void handleMove(QTcpSocket* socket, const QSharedPointer<GameRoom>& room, const QJsonObject& obj);
 };
 
 #endif // GOSERVER_H
@@ -0,0 +1,60 @@
+#include "lobbyindex.h"
+
+bool LobbyIndex::inCategory(const Entry &entry, Category category)
+{
+    switch (category) {
+    case OpenRooms:
+        return entry.state == Open;
+    case InProgressRooms:
+        return entry.state == InProgress;
+    case SpectatableRooms:
+        return entry.state == InProgress && entry.spectators < MAX_SPECTATORS;
+    default:
+        return false;
+    }
+}
+
+void LobbyIndex::upsert(const Entry &entry)
+{
+    auto it = m_entries.find(entry.roomId);
+    for (int c = 0; c < CATEGORY_COUNT; ++c) {
+        Category category = static_cast<Category>(c);
+        bool was = (it != m_entries.end()) && inCategory(*it, category);
+        bool now = inCategory(entry, category);
+        if (was && !now) {
+            m_sets[c].erase(entry.roomId);
+        } else if (!was && now) {
+            m_sets[c].insert(entry.roomId);
+        }
+    }
+    m_entries.insert(entry.roomId, entry);
+}
+
+void LobbyIndex::remove(int roomId)
+{
+    if (m_entries.remove(roomId) == 0)
+        return;
+    for (int c = 0; c < CATEGORY_COUNT; ++c) {
+        m_sets[c].erase(roomId);
+    }
+}
+
+int LobbyIndex::firstOpen() const
+{
+    const std::set<int>& open = m_sets[OpenRooms];
+    return open.empty() ? 0 : *open.begin();
+}
+
+QList<LobbyIndex::Entry> LobbyIndex::page(Category category, int afterRoomId, int limit, int *nextCursor) const
+{
+    QList<Entry> result;
+    const std::set<int>& rooms = m_sets[category];
+    auto it = rooms.upper_bound(afterRoomId);
+    for (; it != rooms.end() && result.size() < limit; ++it) {
+        result.append(m_entries.value(*it));
+    }
+    if (nextCursor) {
+        *nextCursor = (it != rooms.end() && !result.isEmpty()) ? result.last().roomId : 0;
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef LOBBYINDEX_H
+#define LOBBYINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <set>
+
+// 大厅索引：按房间状态分类的有序房间号集合，随房间创建、满员、删除增量维护。
+// 列表查询按房间号游标分页，代价为 O(log n + 页大小)，与房间总数无关
+class LobbyIndex
+{
+public:
+    enum State { Open, InProgress };
+    enum Category { OpenRooms, InProgressRooms, SpectatableRooms, CATEGORY_COUNT };
+
+    // 每个房间最多容纳的观战者
+    static const int MAX_SPECTATORS = 32;
+
+    struct Entry {
+        int roomId = 0;
+        State state = Open;
+        int players = 0;
+        int spectators = 0;
+    };
+
+    // 新增或更新一个房间
+    void upsert(const Entry& entry);
+    void remove(int roomId);
+    bool contains(int roomId) const { return m_entries.contains(roomId); }
+    Entry entry(int roomId) const { return m_entries.value(roomId); }
+
+    // 房间号最小的等待中房间，没有则返回0
+    int firstOpen() const;
+    int count(Category category) const { return static_cast<int>(m_sets[category].size()); }
+
+    // 返回房间号大于 afterRoomId 的至多 limit 个房间；nextCursor 为0表示没有更多
+    QList<Entry> page(Category category, int afterRoomId, int limit, int* nextCursor) const;
+
+    static bool inCategory(const Entry& entry, Category category);
+
+private:
+    QHash<int, Entry> m_entries;
+    std::set<int> m_sets[CATEGORY_COUNT];
+};
+
+#endif // LOBBYINDEX_H
@@ -1,11 +1,73 @@
 #include "mainwindow.h"
 #include "goserver.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 
+// 同机主备：先启动 GoServer --standby，再启动 GoServer；
+// 主服务器退出后热备接管端口，客户端自动重连并恢复对局
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    GoServer server;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption standbyOption("standby", "以热备模式启动，主服务器断开后接管端口");
+    QCommandLineOption portOption("port", "监听端口", "port", "1234");
+    QCommandLineOption replicaOption("replica", "主备之间的本地套接字名，为空则不复制", "name", "GoServer-replica");
+    // 限流参数（0 表示不限制）
+    RateLimitConfig limits;
+    QCommandLineOption messageRateOption("msg-rate", "每个连接每秒最多处理的消息数", "n", QString::number(limits.messagesPerSecond));
+    QCommandLineOption messageBurstOption("msg-burst", "每个连接最多可积攒的消息数", "n", QString::number(limits.messageBurst));
+    QCommandLineOption byteRateOption("byte-rate", "每个连接每秒最多读取的字节数", "bytes", QString::number(limits.bytesPerSecond));
+    QCommandLineOption byteBurstOption("byte-burst", "每个连接最多可积攒的字节数", "bytes", QString::number(limits.byteBurst));
+    QCommandLineOption frameOption("max-frame", "单条消息的最大字节数", "bytes", QString::number(limits.maxFrameBytes));
+    QCommandLineOption connectionRateOption("conn-rate", "每个来源地址每秒最多新建的连接数", "n", QString::number(limits.connectionsPerSecond));
+    QCommandLineOption connectionBurstOption("conn-burst", "每个来源地址最多可积攒的新建连接数", "n", QString::number(limits.connectionBurst));
+    QCommandLineOption violationsOption("max-violations", "丢弃计数超过多少条后断开连接", "n", QString::number(limits.maxViolations));
+    QCommandLineOption violationDecayOption("violation-decay", "丢弃计数每秒衰减多少", "n", QString::number(limits.violationDecayPerSecond));
+    parser.addOption(standbyOption);
+    parser.addOption(portOption);
+    parser.addOption(replicaOption);
+    parser.addOption(messageRateOption);
+    parser.addOption(messageBurstOption);
+    parser.addOption(byteRateOption);
+    parser.addOption(byteBurstOption);
+    parser.addOption(frameOption);
+    parser.addOption(connectionRateOption);
+    parser.addOption(connectionBurstOption);
+    parser.addOption(violationsOption);
+    parser.addOption(violationDecayOption);
+    parser.process(a);
+
+    limits.messagesPerSecond = parser.value(messageRateOption).toDouble();
+    limits.messageBurst = parser.value(messageBurstOption).toDouble();
+    limits.bytesPerSecond = parser.value(byteRateOption).toDouble();
+    limits.byteBurst = parser.value(byteBurstOption).toDouble();
+    limits.maxFrameBytes = parser.value(frameOption).toInt();
+    limits.connectionsPerSecond = parser.value(connectionRateOption).toDouble();
+    limits.connectionBurst = parser.value(connectionBurstOption).toDouble();
+    limits.maxViolations = parser.value(violationsOption).toInt();
+    limits.violationDecayPerSecond = parser.value(violationDecayOption).toDouble();
+
+    GoServer server(parser.value(portOption).toUShort());
+    server.setRateLimits(limits);
+    QString replicaName = parser.value(replicaOption);
+    bool started;
+    if (parser.isSet(standbyOption)) {
+        started = server.startStandby(replicaName);
+    } else {
+        started = server.startPrimary(replicaName);
+        // 端口被占用（通常是热备已接管）：改当热备，等现在的主服务器把事件流发过来
+        if (!started && !replicaName.isEmpty()) {
+            qDebug() << "Port in use, starting as standby instead";
+            started = server.startStandby(replicaName);
+        }
+    }
+    if (!started) {
+        qCritical() << "GoServer failed to start";
+        return 1;
+    }
     MainWindow w;
     //w.show();
     return a.exec();
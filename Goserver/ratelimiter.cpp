@@ -0,0 +1,69 @@
+#include "ratelimiter.h"
+#include <cmath>
+
+TokenBucket::TokenBucket(double rate, double burst, qint64 nowMs)
+    : m_rate(rate), m_burst(burst), m_tokens(burst), m_lastMs(nowMs)
+{
+}
+
+void TokenBucket::refill(qint64 nowMs)
+{
+    if (nowMs > m_lastMs) {
+        m_tokens = qMin(m_burst, m_tokens + m_rate * (nowMs - m_lastMs) / 1000.0);
+        m_lastMs = nowMs;
+    }
+}
+
+bool TokenBucket::consume(double amount, qint64 nowMs)
+{
+    // 速率为0表示不限制
+    if (m_rate <= 0)
+        return true;
+    refill(nowMs);
+    if (m_tokens < amount)
+        return false;
+    m_tokens -= amount;
+    return true;
+}
+
+double TokenBucket::available(qint64 nowMs)
+{
+    if (m_rate <= 0)
+        return HUGE_VAL;
+    refill(nowMs);
+    return m_tokens;
+}
+
+qint64 TokenBucket::msUntil(double amount, qint64 nowMs)
+{
+    double missing = amount - available(nowMs);
+    if (missing <= 0)
+        return 0;
+    return static_cast<qint64>(std::ceil(missing * 1000.0 / m_rate));
+}
+
+DecayingCounter::DecayingCounter(double decay, qint64 nowMs)
+    : m_decay(decay), m_value(0), m_lastMs(nowMs)
+{
+}
+
+void DecayingCounter::decay(qint64 nowMs)
+{
+    if (nowMs > m_lastMs) {
+        m_value = qMax(0.0, m_value - m_decay * (nowMs - m_lastMs) / 1000.0);
+        m_lastMs = nowMs;
+    }
+}
+
+double DecayingCounter::add(double amount, qint64 nowMs)
+{
+    decay(nowMs);
+    m_value += amount;
+    return m_value;
+}
+
+double DecayingCounter::value(qint64 nowMs)
+{
+    decay(nowMs);
+    return m_value;
+}
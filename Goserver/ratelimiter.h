@@ -0,0 +1,62 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QtGlobal>
+
+// 令牌桶：每秒补充 rate 个令牌，最多积攒 burst 个
+class TokenBucket
+{
+public:
+    TokenBucket(double rate = 0, double burst = 0, qint64 nowMs = 0);
+
+    // 尝试取出 amount 个令牌，不够则不取并返回 false
+    bool consume(double amount, qint64 nowMs);
+    // 当前可用的令牌数
+    double available(qint64 nowMs);
+    // 攒够 amount 个令牌还需要的毫秒数
+    qint64 msUntil(double amount, qint64 nowMs);
+    // 桶已满（长时间未使用，可以回收）
+    bool isFull(qint64 nowMs) { return available(nowMs) >= m_burst; }
+
+private:
+    double m_rate;
+    double m_burst;
+    double m_tokens;
+    qint64 m_lastMs;
+
+    void refill(qint64 nowMs);
+};
+
+// 随时间衰减的计数：每秒减少 decay，最低为0（decay 为0表示不衰减）
+class DecayingCounter
+{
+public:
+    explicit DecayingCounter(double decay = 0, qint64 nowMs = 0);
+
+    // 计数加 amount，返回衰减后的新值
+    double add(double amount, qint64 nowMs);
+    // 当前值
+    double value(qint64 nowMs);
+
+private:
+    double m_decay;
+    double m_value;
+    qint64 m_lastMs;
+
+    void decay(qint64 nowMs);
+};
+
+// 限流参数（0 表示不限制）
+struct RateLimitConfig {
+    double messagesPerSecond = 20;      // 每连接每秒消息数
+    double messageBurst = 40;
+    double bytesPerSecond = 16 * 1024;  // 每连接每秒字节数
+    double byteBurst = 64 * 1024;
+    int maxFrameBytes = 4096;           // 单条消息（一行）的最大长度
+    double connectionsPerSecond = 2;    // 每个来源地址每秒新建连接数
+    double connectionBurst = 10;
+    int maxViolations = 50;             // 被丢弃的消息计数超过该数即断开
+    double violationDecayPerSecond = 1; // 丢弃计数每秒衰减多少（0 表示只增不减）
+};
+
+#endif // RATELIMITER_H
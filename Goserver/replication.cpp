@@ -0,0 +1,157 @@
+#include "replication.h"
+#include "goprotocol.h"
+#include <QDebug>
+
+ReplicationSender::ReplicationSender(const QString &serverName, QObject *parent)
+    : QObject(parent)
+    , m_serverName(serverName)
+    , m_socket(new QLocalSocket(this))
+{
+    connect(m_socket, &QLocalSocket::connected, this, &ReplicationSender::onConnected);
+    connect(m_socket, &QLocalSocket::disconnected, this, &ReplicationSender::onDisconnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &ReplicationSender::readAcks);
+
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ReplicationSender::flush);
+    m_reconnectTimer.setInterval(RECONNECT_INTERVAL_MS);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &ReplicationSender::reconnect);
+}
+
+void ReplicationSender::start()
+{
+    reconnect();
+    m_reconnectTimer.start();
+}
+
+void ReplicationSender::reconnect()
+{
+    if (m_socket->state() == QLocalSocket::UnconnectedState) {
+        m_socket->connectToServer(m_serverName);
+    }
+}
+
+void ReplicationSender::onConnected()
+{
+    qDebug() << "Standby connected (" << m_serverName << ")";
+    // 之前未发出的事件已包含在接下来的快照中
+    m_batch.clear();
+    m_ackedSeq = m_seq;
+    emit standbyConnected();
+}
+
+void ReplicationSender::onDisconnected()
+{
+    qDebug() << "Standby disconnected (" << m_serverName << ")";
+    m_batch.clear();
+    m_flushTimer.stop();
+}
+
+void ReplicationSender::append(QJsonObject event)
+{
+    event["seq"] = ++m_seq;
+    // 没有热备时不积压，热备连上后会收到完整快照
+    if (!isConnected())
+        return;
+
+    m_batch.append(GoProtocol::encode(event));
+    if (m_batch.size() >= MAX_BATCH_BYTES) {
+        flush();
+    } else if (!m_flushTimer.isActive()) {
+        m_flushTimer.start(FLUSH_INTERVAL_MS);
+    }
+}
+
+// 整批一次写出，不等上一批的确认
+void ReplicationSender::flush()
+{
+    m_flushTimer.stop();
+    if (m_batch.isEmpty() || !isConnected())
+        return;
+    m_socket->write(m_batch);
+    m_batch.clear();
+}
+
+void ReplicationSender::readAcks()
+{
+    m_readBuffer.append(m_socket->readAll());
+    for (const QJsonObject& obj : GoProtocol::takeMessages(m_readBuffer)) {
+        m_ackedSeq = static_cast<qint64>(obj["ack"].toDouble());
+    }
+    if (m_seq - m_ackedSeq > 10000) {
+        qDebug() << "Standby is lagging behind by" << (m_seq - m_ackedSeq) << "events";
+    }
+}
+
+ReplicationReceiver::ReplicationReceiver(const QString &serverName, QObject *parent)
+    : QObject(parent)
+    , m_serverName(serverName)
+    , m_server(new QLocalServer(this))
+{
+    connect(m_server, &QLocalServer::newConnection, this, &ReplicationReceiver::onNewConnection);
+}
+
+bool ReplicationReceiver::start()
+{
+    // 清理上次异常退出留下的套接字文件
+    QLocalServer::removeServer(m_serverName);
+    if (!m_server->listen(m_serverName)) {
+        qDebug() << "Standby could not listen on" << m_serverName << ":" << m_server->errorString();
+        return false;
+    }
+    qDebug() << "Standby waiting for primary on" << m_serverName;
+    return true;
+}
+
+void ReplicationReceiver::stop()
+{
+    m_server->close();
+    if (m_primary) {
+        m_primary->disconnect(this);
+        m_primary->close();
+        m_primary->deleteLater();
+        m_primary = nullptr;
+    }
+}
+
+void ReplicationReceiver::onNewConnection()
+{
+    QLocalSocket *socket = m_server->nextPendingConnection();
+    if (m_primary) {
+        // 只跟随一个主服务器，新的连接取代旧的
+        m_primary->disconnect(this);
+        m_primary->close();
+        m_primary->deleteLater();
+    }
+    m_primary = socket;
+    m_readBuffer.clear();
+    connect(m_primary, &QLocalSocket::readyRead, this, &ReplicationReceiver::readEvents);
+    connect(m_primary, &QLocalSocket::disconnected, this, &ReplicationReceiver::onPrimaryDisconnected);
+    qDebug() << "Primary connected";
+}
+
+void ReplicationReceiver::readEvents()
+{
+    m_readBuffer.append(m_primary->readAll());
+    const QList<QJsonObject> events = GoProtocol::takeMessages(m_readBuffer);
+    if (events.isEmpty())
+        return;
+
+    for (const QJsonObject& event : events) {
+        qint64 seq = static_cast<qint64>(event["seq"].toDouble());
+        // 快照从任意序号开始，其余事件必须连续
+        if (event["ev"].toString() != "snapshot" && seq != m_lastSeq + 1) {
+            qDebug() << "Replication gap: expected" << m_lastSeq + 1 << "got" << seq;
+        }
+        m_lastSeq = seq;
+        emit eventReceived(event);
+    }
+    m_primary->write(GoProtocol::encode(QJsonObject{{"ack", m_lastSeq}}));
+}
+
+void ReplicationReceiver::onPrimaryDisconnected()
+{
+    qDebug() << "Primary connection lost";
+    m_primary->deleteLater();
+    m_primary = nullptr;
+    emit primaryLost();
+}
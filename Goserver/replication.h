@@ -0,0 +1,82 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonObject>
+#include <QTimer>
+
+// 主备复制：主服务器把房间生命周期与落子事件写成事件流，
+// 通过本地套接字发送给同机的热备进程。事件格式与客户端协议相同（一行一条JSON），
+// 每条带全局递增的 "seq"；热备处理完一批后回复 {"ack": seq}。
+
+// 主服务器端：攒批发送，不等待确认（流水线）
+class ReplicationSender : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReplicationSender(const QString& serverName, QObject *parent = nullptr);
+
+    // 攒批间隔（毫秒）与单批最大字节数
+    static const int FLUSH_INTERVAL_MS = 5;
+    static const int MAX_BATCH_BYTES = 64 * 1024;
+    // 连接热备失败后的重试间隔（毫秒）
+    static const int RECONNECT_INTERVAL_MS = 1000;
+
+    void start();
+    // 追加一条事件（分配序号后放入当前批次）
+    void append(QJsonObject event);
+    bool isConnected() const { return m_socket->state() == QLocalSocket::ConnectedState; }
+
+signals:
+    // 热备（重新）连上，需要先发送一份完整快照
+    void standbyConnected();
+
+private slots:
+    void flush();
+    void onConnected();
+    void onDisconnected();
+    void readAcks();
+    void reconnect();
+
+private:
+    QString m_serverName;
+    QLocalSocket *m_socket;
+    QTimer m_flushTimer;
+    QTimer m_reconnectTimer;
+    QByteArray m_batch;           // 尚未写出的事件
+    QByteArray m_readBuffer;
+    qint64 m_seq = 0;             // 最后分配的序号
+    qint64 m_ackedSeq = 0;        // 热备确认到的序号
+};
+
+// 热备端：接收事件流并交给 GoServer 应用，主服务器断开即视为故障
+class ReplicationReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReplicationReceiver(const QString& serverName, QObject *parent = nullptr);
+
+    bool start();
+    void stop();
+
+signals:
+    void eventReceived(const QJsonObject& event);
+    // 主服务器连接断开（崩溃或重启）
+    void primaryLost();
+
+private slots:
+    void onNewConnection();
+    void readEvents();
+    void onPrimaryDisconnected();
+
+private:
+    QString m_serverName;
+    QLocalServer *m_server;
+    QLocalSocket *m_primary = nullptr;
+    QByteArray m_readBuffer;
+    qint64 m_lastSeq = 0;
+};
+
+#endif // REPLICATION_H